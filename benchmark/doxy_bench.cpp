@@ -0,0 +1,500 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+/** Settings for the generated project, every value can be changed on the command line
+ */
+struct BenchOptions {
+   int files         = 100;       // number of header files
+   int classes       = 10;        // classes per file
+   int members       = 8;         // methods per class
+   int templateDepth = 2;         // length of the chain of template base classes in each file
+   int docDensity    = 80;        // percentage of documented methods
+   int pages         = 10;        // number of markdown pages
+   int crossRefs     = 3;         // references to other classes per class
+   int filesPerDir   = 100;
+   uint seed         = 1;
+
+   QString outputDir = "doxypress_bench";
+   QString doxyPress;
+};
+
+/** Deterministic pseudo random numbers, the generated project only depends on the seed
+ */
+class BenchRandom
+{
+ public:
+   explicit BenchRandom(uint seed)
+      : m_state(quint64(seed) * 2654435761u + 1)
+   { }
+
+   // returns a value in the range 0 to limit - 1
+   int next(int limit) {
+      m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+
+      if (limit <= 0) {
+         return 0;
+      }
+
+      return int((m_state >> 33) % quint64(limit));
+   }
+
+ private:
+   quint64 m_state;
+};
+
+static void usage()
+{
+   printf("Usage: doxypress_bench [options]\n\n"
+          "Generates a synthetic C++ project and optionally runs DoxyPress on it\n\n"
+          "   --output <dir>            directory for the generated project (default doxypress_bench)\n"
+          "   --files <n>               number of header files (default 100)\n"
+          "   --classes <n>             classes per file (default 10)\n"
+          "   --members <n>             methods per class (default 8)\n"
+          "   --template-depth <n>      template base classes per file (default 2)\n"
+          "   --doc-density <percent>   percentage of documented methods (default 80)\n"
+          "   --pages <n>               number of markdown pages (default 10)\n"
+          "   --cross-refs <n>          references to other classes per class (default 3)\n"
+          "   --files-per-dir <n>       header files per directory (default 100)\n"
+          "   --seed <n>                seed for the generator (default 1)\n"
+          "   --doxypress <path>        run this DoxyPress binary on the project and report the results\n\n");
+}
+
+static bool parseOptions(const QStringList &argList, BenchOptions &options)
+{
+   for (int i = 0; i < argList.count(); ++i) {
+      const QString &arg = argList[i];
+
+      if (arg == "--help") {
+         usage();
+         exit(0);
+      }
+
+      if (i + 1 >= argList.count()) {
+         fprintf(stderr, "Option %s is unknown or is missing a value\n", csPrintable(arg));
+         return false;
+      }
+
+      const QString value = argList[++i];
+
+      bool ok   = true;
+      int count = value.toInteger<int>(&ok);
+
+      if (arg == "--output") {
+         options.outputDir = value;
+         continue;
+
+      } else if (arg == "--doxypress") {
+         options.doxyPress = value;
+         continue;
+      }
+
+      if (! ok || count < 0) {
+         fprintf(stderr, "Option %s requires a positive number\n", csPrintable(arg));
+         return false;
+      }
+
+      if (arg == "--files") {
+         options.files = count;
+
+      } else if (arg == "--classes") {
+         options.classes = count;
+
+      } else if (arg == "--members") {
+         options.members = count;
+
+      } else if (arg == "--template-depth") {
+         options.templateDepth = count;
+
+      } else if (arg == "--doc-density") {
+         options.docDensity = qMin(count, 100);
+
+      } else if (arg == "--pages") {
+         options.pages = count;
+
+      } else if (arg == "--cross-refs") {
+         options.crossRefs = count;
+
+      } else if (arg == "--files-per-dir") {
+         options.filesPerDir = qMax(count, 1);
+
+      } else if (arg == "--seed") {
+         options.seed = count;
+
+      } else {
+         fprintf(stderr, "Option %s is unknown\n", csPrintable(arg));
+         return false;
+      }
+   }
+
+   return true;
+}
+
+static bool writeFile(const QString &fileName, const QString &text)
+{
+   QFile file(fileName);
+
+   if (! file.open(QIODevice::WriteOnly)) {
+      fprintf(stderr, "Unable to open file for writing %s, error: %d\n", csPrintable(fileName), file.error());
+      return false;
+   }
+
+   file.write(text.toUtf8());
+
+   return true;
+}
+
+static QString dirName(const BenchOptions &options, int fileIndex)
+{
+   return QString("dir_%1").formatArg(fileIndex / options.filesPerDir);
+}
+
+// fully qualified name of a class, classes are numbered across the whole project
+static QString className(const BenchOptions &options, int classIndex)
+{
+   int fileIndex = classIndex / qMax(options.classes, 1);
+   return QString("%1::Class_%2").formatArg(dirName(options, fileIndex)).formatArg(classIndex);
+}
+
+static QString generateHeader(const BenchOptions &options, int fileIndex, BenchRandom &random)
+{
+   const int totalClasses = options.files * options.classes;
+   const QString guard    = QString("BENCH_FILE_%1_H").formatArg(fileIndex);
+
+   QString text;
+
+   text += QString("/** \\file\n *  \\brief Declarations of generated file %1.\n */\n\n").formatArg(fileIndex);
+   text += "#ifndef " + guard + "\n#define " + guard + "\n\n";
+
+   if (fileIndex > 0) {
+      // include an earlier file so the include graph has some depth
+      int other = random.next(fileIndex);
+      text += QString("#include <%1/file_%2.h>\n\n").formatArg(dirName(options, other)).formatArg(other);
+   }
+
+   text += "namespace " + dirName(options, fileIndex) + " {\n\n";
+
+   // chain of template base classes
+   for (int depth = 0; depth < options.templateDepth; ++depth) {
+      const QString name = QString("Holder_%1_%2").formatArg(fileIndex).formatArg(depth);
+
+      text += QString("/** \\brief Template base class at level %1.\n *  \\tparam T type of the stored value\n */\n").formatArg(depth);
+      text += "template <typename T>\nclass " + name;
+
+      if (depth > 0) {
+         text += QString(" : public Holder_%1_%2<T>").formatArg(fileIndex).formatArg(depth - 1);
+      }
+
+      text += "\n{\n public:\n";
+      text += QString("   /** Returns the value stored at level %1. */\n").formatArg(depth);
+      text += QString("   const T &value_%1() const {\n      return m_value;\n   }\n\n").formatArg(depth);
+      text += " private:\n   T m_value;\n};\n\n";
+   }
+
+   for (int i = 0; i < options.classes; ++i) {
+      const int classIndex = fileIndex * options.classes + i;
+      const QString name   = QString("Class_%1").formatArg(classIndex);
+
+      text += QString("/** \\brief Generated class %1.\n *\n").formatArg(classIndex);
+      text += " *  This class is part of a synthetic project used to measure the throughput of DoxyPress.\n";
+
+      for (int ref = 0; ref < options.crossRefs && totalClasses > 1; ++ref) {
+         text += " *  \\see " + className(options, random.next(totalClasses)) + "\n";
+      }
+
+      text += " */\nclass " + name;
+
+      if (options.templateDepth > 0) {
+         text += QString(" : public Holder_%1_%2<int>").formatArg(fileIndex).formatArg(options.templateDepth - 1);
+      }
+
+      text += "\n{\n public:\n";
+
+      for (int member = 0; member < options.members; ++member) {
+         if (random.next(100) < options.docDensity) {
+            text += QString("   /** \\brief Computes result %1 of this class.\n").formatArg(member);
+            text += "    *  \\param count number of iterations\n";
+            text += "    *  \\return the computed result\n    */\n";
+         }
+
+         text += QString("   int method_%1(int count) const {\n").formatArg(member);
+         text += QString("      return count * %1 + m_data;\n   }\n\n").formatArg(random.next(1000));
+      }
+
+      text += " private:\n   int m_data;\n};\n\n";
+   }
+
+   text += "}\n\n#endif\n";
+
+   return text;
+}
+
+static QString generatePage(const BenchOptions &options, int pageIndex, BenchRandom &random)
+{
+   const int totalClasses = options.files * options.classes;
+
+   QString text;
+
+   text += QString("Generated page %1 {#page_%1}\n===================\n\n").formatArg(pageIndex);
+   text += "This page is part of a synthetic project used to measure the throughput of DoxyPress.\n\n";
+
+   if (pageIndex > 0) {
+      text += QString("Continues from \\ref page_%1.\n\n").formatArg(pageIndex - 1);
+   }
+
+   text += "Related classes\n---------------\n\n";
+
+   for (int ref = 0; ref < options.crossRefs && totalClasses > 0; ++ref) {
+      text += "- " + className(options, random.next(totalClasses)) + "\n";
+   }
+
+   text += "\n";
+
+   return text;
+}
+
+static QJsonArray toJsonArray(const QStringList &list)
+{
+   QJsonArray retval;
+
+   for (const auto &item : list) {
+      retval.append(item);
+   }
+
+   return retval;
+}
+
+static QString generateProject(const BenchOptions &options, const QString &outputDir)
+{
+   QJsonObject general;
+   general.insert("project-name",     QString("Synthetic Benchmark"));
+   general.insert("output-dir",       outputDir + "/output");
+   general.insert("input-source",     toJsonArray(QStringList{ outputDir + "/src", outputDir + "/pages" }));
+   general.insert("input-patterns",   toJsonArray(QStringList{ "*.h", "*.md" }));
+   general.insert("input-recursive",  true);
+   general.insert("include-path",     toJsonArray(QStringList{ outputDir + "/src" }));
+   general.insert("extract-all",      true);
+   general.insert("source-code",      true);
+   general.insert("generate-html",    true);
+   general.insert("generate-latex",   false);
+   general.insert("warnings",         false);
+   general.insert("profile-report",   outputDir + "/profile.json");
+
+   QJsonObject object;
+   object.insert("doxypress-format", 1);
+   object.insert("benchmark", general);
+
+   return QString::fromUtf8(QJsonDocument(object).toJson());
+}
+
+static bool generate(const BenchOptions &options, const QString &outputDir)
+{
+   BenchRandom random(options.seed);
+   QDir dir;
+
+   for (int fileIndex = 0; fileIndex < options.files; ++fileIndex) {
+      const QString path = outputDir + "/src/" + dirName(options, fileIndex);
+
+      if (fileIndex % options.filesPerDir == 0 && ! dir.mkpath(path)) {
+         fprintf(stderr, "Unable to create directory %s\n", csPrintable(path));
+         return false;
+      }
+
+      QString fileName = QString("%1/file_%2.h").formatArg(path).formatArg(fileIndex);
+
+      if (! writeFile(fileName, generateHeader(options, fileIndex, random))) {
+         return false;
+      }
+   }
+
+   if (! dir.mkpath(outputDir + "/pages")) {
+      fprintf(stderr, "Unable to create directory %s/pages\n", csPrintable(outputDir));
+      return false;
+   }
+
+   for (int pageIndex = 0; pageIndex < options.pages; ++pageIndex) {
+      QString fileName = QString("%1/pages/page_%2.md").formatArg(outputDir).formatArg(pageIndex);
+
+      if (! writeFile(fileName, generatePage(options, pageIndex, random))) {
+         return false;
+      }
+   }
+
+   return writeFile(outputDir + "/doxy_bench.json", generateProject(options, outputDir));
+}
+
+// peak resident set size of the largest child process in bytes
+static qint64 childPeakMemory()
+{
+#ifdef _WIN32
+   return 0;
+
+#else
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_CHILDREN, &usage) != 0) {
+      return 0;
+   }
+
+#if defined(__APPLE__)
+   return usage.ru_maxrss;
+#else
+   return qint64(usage.ru_maxrss) * 1024;
+#endif
+
+#endif
+}
+
+static int countPages(const QString &htmlDir)
+{
+   int retval = 0;
+
+   QDirIterator iter(htmlDir, QStringList{ "*.html" }, QDir::Files, QDirIterator::Subdirectories);
+
+   while (iter.hasNext()) {
+      iter.next();
+      ++retval;
+   }
+
+   return retval;
+}
+
+static bool runDoxyPress(const BenchOptions &options, const QString &outputDir)
+{
+   QDir(outputDir + "/output").removeRecursively();
+   QFile::remove(outputDir + "/profile.json");
+
+   QElapsedTimer timer;
+   timer.start();
+
+   QProcess process;
+   process.setProcessChannelMode(QProcess::ForwardedChannels);
+   process.start(options.doxyPress, QStringList{ outputDir + "/doxy_bench.json" });
+
+   if (! process.waitForStarted() || ! process.waitForFinished(-1)) {
+      fprintf(stderr, "Unable to run %s\n", csPrintable(options.doxyPress));
+      return false;
+   }
+
+   const double wallTime = timer.nsecsElapsed() / 1e9;
+
+   if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+      fprintf(stderr, "DoxyPress failed with exit code %d\n", process.exitCode());
+      return false;
+   }
+
+   QFile file(outputDir + "/profile.json");
+
+   if (! file.open(QIODevice::ReadOnly)) {
+      fprintf(stderr, "Unable to read the profile report %s/profile.json\n", csPrintable(outputDir));
+      return false;
+   }
+
+   QJsonObject total = QJsonDocument::fromJson(file.readAll()).object().value("total").toObject();
+
+   // files are read in the parsing phase, pages are written by the phases generating output
+   double parseTime  = 0;
+   double outputTime = 0;
+
+   printf("\n%-60s %10s %12s\n", "Phase", "Wall (s)", "Peak (MB)");
+
+   for (auto item : total.value("phases").toArray()) {
+      QJsonObject phase = item.toObject();
+
+      QString name = phase.value("name").toString();
+      double wall  = phase.value("wall-ms").toDouble() / 1000.0;
+
+      if (name == "Parsing") {
+         parseTime += wall;
+
+      } else if (name.startsWith("Generating") || name.startsWith("Finalizing")) {
+         outputTime += wall;
+      }
+
+      printf("%-60s %10.3f %12.1f\n", csPrintable(name.left(60)), wall, phase.value("peak-rss-kb").toDouble() / 1024.0);
+   }
+
+   const int files = options.files + options.pages;
+   const int pages = countPages(outputDir + "/output/html");
+
+   printf("\n");
+   printf("Input files:         %d\n", files);
+   printf("Generated pages:     %d\n", pages);
+   printf("Wall time (s):       %.3f\n", wallTime);
+   printf("Files/sec (parsing): %.1f\n", parseTime  > 0 ? files / parseTime  : 0.0);
+   printf("Pages/sec (output):  %.1f\n", outputTime > 0 ? pages / outputTime : 0.0);
+   printf("Peak RSS (MB):       %.1f\n\n", childPeakMemory() / (1024.0 * 1024.0));
+
+   return true;
+}
+
+int main(int argc, char **argv)
+{
+   QCoreApplication app(argc, argv);
+
+   QStringList argList;
+
+   for (int k = 1; k < argc; ++k) {
+      argList.append(QString::fromUtf8(argv[k]));
+   }
+
+   BenchOptions options;
+
+   if (! parseOptions(argList, options)) {
+      usage();
+      return 1;
+   }
+
+   const QString outputDir = QDir(options.outputDir).absolutePath();
+
+   QDir(outputDir + "/src").removeRecursively();
+   QDir(outputDir + "/pages").removeRecursively();
+
+   QElapsedTimer timer;
+   timer.start();
+
+   if (! generate(options, outputDir)) {
+      return 1;
+   }
+
+   printf("Generated %d files with %d classes and %d pages in %s (%.3f s)\n", options.files,
+         options.files * options.classes, options.pages, csPrintable(outputDir), timer.nsecsElapsed() / 1e9);
+
+   if (! options.doxyPress.isEmpty() && ! runDoxyPress(options, outputDir)) {
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,74 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#include <chunkedbuffer.h>
+
+// upper limit for the amount of text waiting in the buffer in bytes
+static const int s_maxPendingSize = 1024 * 1024;
+
+ChunkedBuffer::ChunkedBuffer()
+   : m_pendingSize(0), m_closed(false)
+{
+}
+
+void ChunkedBuffer::append(QString text)
+{
+   if (text.isEmpty()) {
+      return;
+   }
+
+   QMutexLocker locker(&m_mutex);
+
+   while (m_pendingSize > 0 && m_pendingSize + text.size_storage() > s_maxPendingSize) {
+      m_spaceFree.wait(&m_mutex);
+   }
+
+   m_pendingSize += text.size_storage();
+   m_chunks.enqueue(std::move(text));
+
+   m_chunkReady.wakeAll();
+}
+
+void ChunkedBuffer::close()
+{
+   QMutexLocker locker(&m_mutex);
+
+   m_closed = true;
+   m_chunkReady.wakeAll();
+}
+
+bool ChunkedBuffer::take(QString &chunk)
+{
+   QMutexLocker locker(&m_mutex);
+
+   while (m_chunks.isEmpty() && ! m_closed) {
+      m_chunkReady.wait(&m_mutex);
+   }
+
+   if (m_chunks.isEmpty()) {
+      chunk = QString();
+      return false;
+   }
+
+   chunk = m_chunks.dequeue();
+   m_pendingSize -= chunk.size_storage();
+
+   m_spaceFree.wakeAll();
+
+   return true;
+}
@@ -0,0 +1,58 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#ifndef CHUNKEDBUFFER_H
+#define CHUNKEDBUFFER_H
+
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QWaitCondition>
+
+/** Passes text from a producer thread to a consumer thread in chunks
+ *
+ *  The producer appends chunks and closes the buffer when done, the consumer takes them in
+ *  the same order. The amount of text waiting in the buffer is bounded, a producer which runs
+ *  ahead blocks until the consumer has caught up.
+ */
+class ChunkedBuffer
+{
+ public:
+   ChunkedBuffer();
+
+   // adds a chunk, waits while the buffer is full
+   void append(QString text);
+
+   // marks the end of the text, no more chunks may be appended
+   void close();
+
+   // removes the next chunk, waits until one is available, returns false at the end of the text
+   bool take(QString &chunk);
+
+ private:
+   QQueue<QString> m_chunks;
+
+   int  m_pendingSize;
+   bool m_closed;
+
+   QMutex          m_mutex;
+   QWaitCondition  m_chunkReady;
+   QWaitCondition  m_spaceFree;
+};
+
+#endif
@@ -49,6 +49,11 @@ class CiteDict
    /** return true if there are no citations   */
    bool isEmpty() const;
 
+   /** return the number of labels in the database */
+   int count() const {
+      return m_entries.count();
+   }
+
    /* writes the latex code for the bibliography section to text stream */
    void writeLatexBibliography(QTextStream &t);
 
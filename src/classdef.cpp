@@ -34,6 +34,8 @@
 #include <language.h>
 #include <layout.h>
 #include <message.h>
+#include <outputcache.h>
+#include <trace.h>
 #include <util.h>
 
 ClassDef::ClassDef(const QString &defFileName, int defLine, int defColumn, const QString &x_name, CompoundType ct,
@@ -1907,6 +1909,7 @@ QString ClassDef::title() const
 void ClassDef::writeDocumentation(OutputList &ol)
 {
    QSharedPointer<ClassDef> self = sharedFrom(this);
+   Trace::Scope trace("class", name());
 
    static const bool generateTreeView    = Config::getBool("generate-treeview");
    static const bool separateMemberPages = Config::getBool("separate-member-pages");
@@ -2005,11 +2008,13 @@ void ClassDef::writeDocumentationForInnerClasses(OutputList &ol)
 
    for (auto innerCd : m_innerClasses) {
       if (innerCd->isLinkableInProject() && innerCd->templateMaster() == nullptr &&
-            protectionLevelVisible(innerCd->protection()) && ! innerCd->isEmbeddedInOuterScope() ) {
+            protectionLevelVisible(innerCd->protection()) && ! innerCd->isEmbeddedInOuterScope() &&
+            ! OutputCache::isUpToDate(innerCd)) {
 
          msg("Generating docs for nested compound %s\n", csPrintable(innerCd->name()));
          innerCd->writeDocumentation(ol);
          innerCd->writeMemberList(ol);
+         OutputCache::endPage();
       }
 
       innerCd->writeDocumentationForInnerClasses(ol);
@@ -19,7 +19,10 @@
 #ifndef COMMENTCNV_H
 #define COMMENTCNV_H
 
+class ChunkedBuffer;
+
 extern QString convertCppComments(const QString &inBuf, const QString &fileName);
+extern QString convertCppComments(ChunkedBuffer &input, const QString &fileName);
 
 #endif
 
@@ -16,8 +16,11 @@
 *
 *************************************************************************/
 
+#include <QCryptographicHash>
 #include <QDir>
 
+#include <algorithm>
+
 #include <config.h>
 
 #include <doxy_setup.h>
@@ -1141,6 +1144,64 @@ Qt::CaseSensitivity Config::getCase(const QString &name)
    return isCase;
 }
 
+// hash of all settings which can change the parsed entries or the generated output,
+// used to discard the parse, macro and page caches of an earlier run
+QByteArray Config::getCacheChecksum()
+{
+   // options which only change how DoxyPress runs
+   static const QStringList skipNames = { "file-version-batch", "filter-persistent", "incremental-output",
+         "output-async-write", "parse-cache-dir", "parse-num-threads", "profile-report" };
+
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+
+   auto addValue = [&hash, &skipNames] (const QString &name, const QString &value) {
+      if (! skipNames.contains(name)) {
+         hash.addData(name.toUtf8());
+         hash.addData("=", 1);
+         hash.addData(value.toUtf8());
+         hash.addData("\n", 1);
+      }
+   };
+
+   // hash iteration order is not stable, sort the keys
+   QStringList keys = m_cfgBool.keys();
+   std::sort(keys.begin(), keys.end());
+
+   for (const auto &key : keys) {
+      addValue(key, m_cfgBool.value(key).value ? "true" : "false");
+   }
+
+   keys = m_cfgInt.keys();
+   std::sort(keys.begin(), keys.end());
+
+   for (const auto &key : keys) {
+      addValue(key, QString::number(m_cfgInt.value(key).value));
+   }
+
+   keys = m_cfgEnum.keys();
+   std::sort(keys.begin(), keys.end());
+
+   for (const auto &key : keys) {
+      addValue(key, m_cfgEnum.value(key).value);
+   }
+
+   keys = m_cfgList.keys();
+   std::sort(keys.begin(), keys.end());
+
+   for (const auto &key : keys) {
+      addValue(key, m_cfgList.value(key).value.join("\x01"));
+   }
+
+   keys = m_cfgString.keys();
+   std::sort(keys.begin(), keys.end());
+
+   for (const auto &key : keys) {
+      addValue(key, m_cfgString.value(key).value);
+   }
+
+   return hash.result();
+}
+
 void Config::loadCmd_Aliases()
 {
    // add aliases to a dictionary
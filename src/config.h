@@ -45,6 +45,7 @@ class Config
       static void setList(const QString &name, const QStringList &data);
 
       static Qt::CaseSensitivity getCase(const QString &name);
+      static QByteArray getCacheChecksum();
 
       enum DataSource { DEFAULT, PROJECT };
 
@@ -114,6 +114,7 @@ void Config::load_Defaults()
    m_cfgString.insert("project-logo",            struc_CfgString { QString(),      DEFAULT } );
 
    m_cfgString.insert("output-dir",              struc_CfgString { QString(),      DEFAULT } );
+   m_cfgBool.insert("output-async-write",        struc_CfgBool   { false,          DEFAULT } );
 
    m_cfgBool.insert("optimize-cplus",            struc_CfgBool   { true,           DEFAULT } );
    m_cfgBool.insert("optimize-java",             struc_CfgBool   { false,          DEFAULT } );
@@ -204,6 +205,7 @@ void Config::load_Defaults()
    // tab 2 -build options
    m_cfgList.insert("enabled-sections",          struc_CfgList   { QStringList(),  DEFAULT } );
    m_cfgString.insert("file-version-filter",     struc_CfgString { QString(),      DEFAULT } );
+   m_cfgBool.insert("file-version-batch",        struc_CfgBool   { false,          DEFAULT } );
    m_cfgString.insert("main-page-name",          struc_CfgString { "",             DEFAULT } );
    m_cfgBool.insert("main-page-omit",            struc_CfgBool   { false,          DEFAULT } );
    m_cfgString.insert("layout-file",             struc_CfgString { QString(),      DEFAULT } );
@@ -228,6 +230,7 @@ void Config::load_Defaults()
    m_cfgBool.insert("warn-undoc-param",          struc_CfgBool   { false,           DEFAULT } );
    m_cfgString.insert("warn-format",             struc_CfgString { "$file:$line: $text", DEFAULT } );
    m_cfgString.insert("warn-logfile",            struc_CfgString { QString(),       DEFAULT } );
+   m_cfgString.insert("profile-report",          struc_CfgString { QString(),       DEFAULT } );
 
    // tab 2 -input source files
    m_cfgList.insert("input-source",              struc_CfgList   { QStringList(),   DEFAULT } );
@@ -237,6 +240,8 @@ void Config::load_Defaults()
 
    m_cfgString.insert("input-encoding",          struc_CfgString { "UTF-8",         DEFAULT } );
    m_cfgBool.insert("input-recursive",           struc_CfgBool   { false,           DEFAULT } );
+   m_cfgInt.insert("parse-num-threads",          struc_CfgInt    { 1,               DEFAULT } );
+   m_cfgString.insert("parse-cache-dir",         struc_CfgString { QString(),       DEFAULT } );
 
    m_cfgList.insert("exclude-files",             struc_CfgList   { QStringList(),   DEFAULT } );
    m_cfgBool.insert("exclude-symlinks",          struc_CfgBool   { false,           DEFAULT } );
@@ -258,6 +263,7 @@ void Config::load_Defaults()
    // tab 2 -index filters
    m_cfgString.insert("filter-program",          struc_CfgString { QString(),       DEFAULT } );
    m_cfgList.insert("filter-patterns",           struc_CfgList   { QStringList(),   DEFAULT } );
+   m_cfgBool.insert("filter-persistent",         struc_CfgBool   { false,           DEFAULT } );
    m_cfgBool.insert("filter-source-files",       struc_CfgBool   { false,           DEFAULT } );
    m_cfgList.insert("filter-source-patterns",    struc_CfgList   { QStringList(),   DEFAULT } );
 
@@ -286,6 +292,7 @@ void Config::load_Defaults()
    m_cfgString.insert("clang-dialect",           struc_CfgString { "--std=c++14",   DEFAULT } );
    m_cfgBool.insert("clang-use-headers",         struc_CfgBool   { true,            DEFAULT } );
    m_cfgList.insert("clang-flags",               struc_CfgList   { QStringList(),   DEFAULT } );
+   m_cfgList.insert("clang-pch-headers",         struc_CfgList   { QStringList(),   DEFAULT } );
 
    // tab 2 - source listing
    m_cfgBool.insert("source-code",               struc_CfgBool   { false,           DEFAULT } );
@@ -367,6 +374,7 @@ void Config::load_Defaults()
 
    // tab 3 - html
    m_cfgString.insert("html-output",             struc_CfgString { "html",          DEFAULT } );
+   m_cfgBool.insert("incremental-output",        struc_CfgBool   { false,           DEFAULT } );
    m_cfgString.insert("html-file-extension",     struc_CfgString { ".html",         DEFAULT } );
    m_cfgString.insert("html-header",             struc_CfgString { QString(),       DEFAULT } );
    m_cfgString.insert("html-footer",             struc_CfgString { QString(),       DEFAULT } );
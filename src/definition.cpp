@@ -22,6 +22,7 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 #include <definition.h>
@@ -32,8 +33,10 @@
 #include <htags.h>
 #include <language.h>
 #include <message.h>
+#include <outputcache.h>
 #include <outputlist.h>
 #include <parse_base.h>
+#include <sourcecache.h>
 #include <util.h>
 
 class Definition_Private
@@ -566,6 +569,63 @@ void Definition::setInbodyDocumentation(const QString &d, const QString &inbodyF
 }
 
 
+/** Reads a source file from the SourceCache, mimics the stdio calls the fragment parser used */
+class FragmentReader
+{
+ public:
+   FragmentReader(const SourceCache::FileData &data)
+      : m_data(data.contents.constData()), m_size(data.contents.size()), m_pos(0), m_eof(false)
+   { }
+
+   bool atEnd() const {
+      return m_eof;
+   }
+
+   int getChar() {
+      if (m_pos >= m_size) {
+         m_eof = true;
+         return EOF;
+      }
+
+      return static_cast<uchar>(m_data[m_pos++]);
+   }
+
+   // returns the rest of the current line including the newline
+   QByteArray readLine() {
+      if (m_pos >= m_size) {
+         m_eof = true;
+         return QByteArray();
+      }
+
+      const char *begin = m_data + m_pos;
+      const char *end   = static_cast<const char *>(memchr(begin, '\n', m_size - m_pos));
+
+      int len;
+
+      if (end == nullptr) {
+         len   = m_size - m_pos;
+         m_eof = true;
+
+      } else {
+         len = end - begin + 1;
+      }
+
+      m_pos += len;
+
+      return QByteArray(begin, len);
+   }
+
+   void seek(int pos) {
+      m_pos = pos;
+   }
+
+ private:
+   const char *m_data;
+   int m_size;
+   int m_pos;
+   bool m_eof;
+};
+
 /*! Reads a fragment of code from file \a fileName starting at
  * line \a startLine and ending at line \a endLine (inclusive). The fragment is
  * stored in \a result. If false is returned the code fragment could not be found
@@ -584,51 +644,49 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
       return false;   // not a valid file name
    }
 
-   QString tmpResult;
+   QByteArray tmpResult;
    QString filter = getFileFilter(fileName, true);
 
-   FILE *f = nullptr;
    bool usePipe = ! filter.isEmpty() && filterSourceFiles;
 
    SrcLangExt lang = getLanguageFromFileName(fileName);
 
-   if (! usePipe) {
-      // no filter given or wanted
-      f = fopen(fileName.toUtf8().constData(), "r");
-
-   } else {
-      // use filter
-      QString cmd = filter + " \"" + fileName + "\"";
-      f = popen(cmd.toUtf8().constData(), "r");
-   }
+   // file is read or filtered only once, fragments are located using the line table
+   SourceCache::FileData fileData;
+   bool isOpened = SourceCache::getFile(fileName, usePipe ? filter : QString(), fileData);
 
    // for TCL, Python, and Fortran no bracket search is possible
    bool found = (lang == SrcLangExt_Tcl) || (lang == SrcLangExt_Python) || (lang == SrcLangExt_Fortran);
 
-   if (f) {
+   if (isOpened) {
+      FragmentReader f(fileData);
+
       int c      = 0;
       int col    = 0;
       int lineNr = 1;
 
       // skip until the startLine has reached
+      if (startLine > 1) {
 
-      while (lineNr < startLine && !feof(f)) {
-         while ((c = fgetc(f)) != '\n' && c != EOF) /* skip */;
-         lineNr++;
+         if (startLine - 1 < fileData.lineOffsets.size()) {
+            f.seek(fileData.lineOffsets[startLine - 1]);
+            lineNr = startLine;
 
-         if (found && c == '\n') {
-            c = '\0';
+         } else {
+            // file has less lines
+            f.seek(fileData.contents.size());
+            f.getChar();
          }
       }
 
-      if (! feof(f)) {
+      if (! f.atEnd()) {
          // skip until the opening bracket or lonely : is found
          char cn = 0;
 
-         while (lineNr <= endLine && ! feof(f) && ! found) {
+         while (lineNr <= endLine && ! f.atEnd() && ! found) {
             int pc = 0;
 
-            while ((c = fgetc(f)) != '{' && c != ':' && c != EOF) {
+            while ((c = f.getChar()) != '{' && c != ':' && c != EOF) {
 
                if (c == '\n') {
                   lineNr++;
@@ -640,7 +698,7 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
                } else if (pc == '/' && c == '/') {
                   // skip single line comment
 
-                  while ((c = fgetc(f)) != '\n' && c != EOF) {
+                  while ((c = f.getChar()) != '\n' && c != EOF) {
                      pc = c;
                   }
 
@@ -651,7 +709,7 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
                } else if (pc == '/' && c == '*') {
                   // skip C style comment
 
-                  while (((c = fgetc(f)) != '/' || pc != '*') && c != EOF) {
+                  while (((c = f.getChar()) != '/' || pc != '*') && c != EOF) {
                      if (c == '\n') {
                         lineNr++;
                         col = 0;
@@ -667,7 +725,7 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
             }
 
             if (c == ':') {
-               cn = fgetc(f);
+               cn = f.getChar();
                if (cn != ':') {
                   found = true;
                }
@@ -683,15 +741,12 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
             // at the right column so that the opening brace lines up with the closing brace
 
             if (endLine != startLine) {
-               QString spaces;
-               spaces.fill(' ', col);
-
-               tmpResult += spaces;
+               tmpResult += QByteArray(col, ' ');
             }
 
             // copy until end of line
             if (c) {
-               tmpResult += c;
+               tmpResult += char(c);
             }
 
             startLine = lineNr;
@@ -704,30 +759,11 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
                }
             }
 
-            const int maxLineLength = 4096;
-            char lineStr[maxLineLength];
-
             do {
-               int size_read;
-
-               do {
-                  // read up to maxLineLength-1 bytes, the last byte being zero
-                  char *p = fgets(lineStr, maxLineLength, f);
-
-                  if (p) {
-                     size_read = qstrlen(p);
-
-                  } else { // nothing read
-                     size_read = -1;
-                     lineStr[0] = '\0';
-                  }
-                  tmpResult += lineStr;
-
-               } while (size_read == (maxLineLength - 1));
-
+               tmpResult += f.readLine();
                lineNr++;
 
-            } while (lineNr <= endLine && ! feof(f));
+            } while (lineNr <= endLine && ! f.atEnd());
 
             // strip stuff after closing bracket
             int newLineIndex = tmpResult.lastIndexOf('\n');
@@ -742,16 +778,12 @@ static bool readCodeFragment(const QString &fileName, int &startLine, int &endLi
       }
 
       if (usePipe) {
-         pclose(f);
          Debug::print(Debug::FilterOutput, 0, "Filter output\n");
-         Debug::print(Debug::FilterOutput, 0, "-------------\n%s\n-------------\n", csPrintable(tmpResult));
-
-      } else {
-         fclose(f);
+         Debug::print(Debug::FilterOutput, 0, "-------------\n%s\n-------------\n", tmpResult.constData());
       }
    }
 
-   result = tmpResult;
+   result = QString::fromUtf8(tmpResult);
 
    if (! result.isEmpty() && ! result.endsWith('\n')) {
       result += "\n";
@@ -1441,6 +1473,7 @@ QString Definition::navigationPathAsString() const
    result += "<li class=\"navelem\">";
 
    if (isLinkable()) {
+      OutputCache::addLink(getOutputFileBase(), anchor());
 
       auto gd = dynamic_cast<const GroupDef *>(this);
       auto pd = dynamic_cast<const PageDef *>(this);
@@ -39,6 +39,7 @@
 #include <htmlentity.h>
 #include <language.h>
 #include <message.h>
+#include <outputcache.h>
 #include <parse_md.h>
 #include <portable.h>
 #include <printdocvisitor.h>
@@ -277,6 +278,8 @@ static QString findAndCopyImage(const QString &fileName, DocImage::Type type, bo
       QString inputFile = fd->getFilePath();
       QFile inImage(inputFile);
 
+      OutputCache::addFile(inputFile);
+
       if (inImage.open(QIODevice::ReadOnly)) {
          result = fileName;
 
@@ -2063,6 +2066,7 @@ static void readTextFileByName(const QString &file, QString &text)
       QFileInfo fi(file);
 
       if (fi.exists()) {
+         OutputCache::addFile(file);
          text = fileToString(file, filterSourceFiles);
          return;
       }
@@ -2074,6 +2078,7 @@ static void readTextFileByName(const QString &file, QString &text)
       QFileInfo fi(absFileName);
 
       if (fi.exists()) {
+         OutputCache::addFile(absFileName);
          text = fileToString(absFileName, filterSourceFiles);
          return;
       }
@@ -2084,6 +2089,7 @@ static void readTextFileByName(const QString &file, QString &text)
    QSharedPointer<FileDef> fd;
 
    if ((fd = findFileDef(&Doxy_Globals::exampleNameDict, file, ambig))) {
+      OutputCache::addFile(fd->getFilePath());
       text = fileToString(fd->getFilePath(), filterSourceFiles);
 
    } else if (ambig) {
@@ -2453,6 +2459,7 @@ void DocCopy::parse(QList<DocNode *> &children)
    QSharedPointer<Definition> def = findDocsForMemberOrCompound(m_link, doc, brief);
 
    if (def) {
+      OutputCache::addCopiedDocs(def);
 
       if (s_copyStack.indexOf(def) == -1) {
          // definition not parsed earlier
@@ -3162,6 +3169,7 @@ void DocDotFile::parse()
 
    if (fd) {
       m_file = fd->getFilePath();
+      OutputCache::addFile(m_file);
 
    } else if (ambig) {
       warn_doc_error(s_fileName, doctokenizerYYlineno, "Included dot file name %s is ambiguous.\n"
@@ -3193,6 +3201,7 @@ void DocMscFile::parse()
 
    if (fd) {
       m_file = fd->getFilePath();
+      OutputCache::addFile(m_file);
 
    } else if (ambig) {
       warn_doc_error(s_fileName, doctokenizerYYlineno, "Included msc file name %s is ambiguous.\n"
@@ -3225,6 +3234,7 @@ void DocDiaFile::parse()
 
    if (fd) {
       m_file = fd->getFilePath();
+      OutputCache::addFile(m_file);
 
    } else if (ambig) {
       warn_doc_error(s_fileName, doctokenizerYYlineno, "Included dia file name %s is ambiguous.\n"
@@ -8354,6 +8364,8 @@ static QString processCopyDoc(const QString &data, uint &len)
             QSharedPointer<Definition> def = findDocsForMemberOrCompound(id, doc, brief);
 
             if (def) {
+               OutputCache::addCopiedDocs(def);
+
                if (s_copyStack.indexOf(def) == -1) {
                   // definition not parsed earlier
                   s_copyStack.append(def);
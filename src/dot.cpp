@@ -34,6 +34,7 @@
 #include <membergroup.h>
 #include <portable.h>
 #include <sortedlist.h>
+#include <trace.h>
 #include <util.h>
 
 static QString g_dotFontPath;
@@ -790,6 +791,8 @@ bool DotRunner::run()
 {
    static int logCount = 0;
 
+   Trace::Scope trace("dot", m_file);
+
    int exitCode = 0;
    QString dotArgs;
 
@@ -16,9 +16,16 @@
 *
 *************************************************************************/
 
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <algorithm>
+
 #include <doxy_globals.h>
 #include <doxy_build_info.h>
 #include <filedef.h>
+#include <portable.h>
 
 class GenericsSDict;
 class IndexList;
@@ -124,3 +131,150 @@ QMultiHash<QString, Definition *>  &Doxy_Globals::glossary()
    static QMultiHash<QString, Definition *> data;
    return data;
 }
+
+// ** statistics
+Statistics::Statistics()
+{
+   m_timer.start();
+
+   // phase 0 is the root and holds the entire run
+   m_phases.append(Phase{ QString("Total"), -1, 1, 0, 0, 0, QVector<int>() });
+   m_stack.append(Frame{ 0, 0, portable_cpuTime(), portable_peakMemory() });
+}
+
+void Statistics::begin(const QString &name, bool quiet)
+{
+   if (! quiet) {
+      msg(name);
+   }
+
+   QString phaseName = name.trimmed();
+   int parent = m_stack.last().phase;
+   int index  = -1;
+
+   for (int child : m_phases[parent].children) {
+      if (m_phases[child].name == phaseName) {
+         index = child;
+         break;
+      }
+   }
+
+   if (index == -1) {
+      index = m_phases.count();
+
+      m_phases.append(Phase{ phaseName, parent, 0, 0, 0, 0, QVector<int>() });
+      m_phases[parent].children.append(index);
+   }
+
+   m_phases[index].count++;
+   m_stack.append(Frame{ index, m_timer.nsecsElapsed(), portable_cpuTime(), portable_peakMemory() });
+}
+
+void Statistics::end()
+{
+   if (m_stack.count() <= 1) {
+      // unbalanced call, the root frame is only closed by finish()
+      return;
+   }
+
+   Frame frame  = m_stack.takeLast();
+   Phase &phase = m_phases[frame.phase];
+
+   phase.wallTime   += m_timer.nsecsElapsed() - frame.wallStart;
+   phase.cpuTime    += portable_cpuTime() - frame.cpuStart;
+   phase.peakMemory += portable_peakMemory() - frame.memoryStart;
+}
+
+void Statistics::finish()
+{
+   while (m_stack.count() > 1) {
+      end();
+   }
+
+   const Frame &frame = m_stack.first();
+   Phase &phase       = m_phases[0];
+
+   phase.wallTime   = m_timer.nsecsElapsed() - frame.wallStart;
+   phase.cpuTime    = portable_cpuTime() - frame.cpuStart;
+   phase.peakMemory = portable_peakMemory() - frame.memoryStart;
+}
+
+QVector<int> Statistics::sortedChildren(int index)
+{
+   QVector<int> retval = m_phases[index].children;
+
+   std::stable_sort(retval.begin(), retval.end(), [this] (int a, int b) {
+      return m_phases[a].wallTime > m_phases[b].wallTime;
+   });
+
+   return retval;
+}
+
+void Statistics::printPhase(int index, int depth, qint64 totalTime)
+{
+   const Phase &phase = m_phases[index];
+
+   QString name    = QString(depth * 2, ' ') + phase.name;
+   double percent  = totalTime > 0 ? (100.0 * phase.wallTime) / totalTime : 0.0;
+
+   printf("%-60s %6d %10.3f %10.3f %6.1f%% %10.1f\n", csPrintable(name.left(60)), phase.count,
+         phase.wallTime / 1e9, phase.cpuTime / 1e9, percent, phase.peakMemory / (1024.0 * 1024.0));
+
+   for (int child : sortedChildren(index)) {
+      printPhase(child, depth + 1, totalTime);
+   }
+}
+
+void Statistics::print()
+{
+   finish();
+
+   printf("\n%-60s %6s %10s %10s %7s %10s\n", "Phase", "Count", "Wall (s)", "Cpu (s)", "Wall", "Peak (MB)");
+   printPhase(0, 0, m_phases[0].wallTime);
+   printf("\n");
+}
+
+QJsonObject Statistics::phaseToJson(int index)
+{
+   const Phase &phase = m_phases[index];
+
+   QJsonObject retval;
+   retval.insert("name",        phase.name);
+   retval.insert("count",       phase.count);
+   retval.insert("wall-ms",     phase.wallTime / 1e6);
+   retval.insert("cpu-ms",      phase.cpuTime  / 1e6);
+   retval.insert("peak-rss-kb", double(phase.peakMemory / 1024));
+
+   QJsonArray children;
+
+   for (int child : sortedChildren(index)) {
+      children.append(phaseToJson(child));
+   }
+
+   if (! children.isEmpty()) {
+      retval.insert("phases", children);
+   }
+
+   return retval;
+}
+
+bool Statistics::writeReport(const QString &fileName)
+{
+   finish();
+
+   QJsonObject object;
+   object.insert("version", versionString);
+   object.insert("date",    QDateTime::currentDateTime().toString(Qt::ISODate));
+   object.insert("total",   phaseToJson(0));
+
+   QFile file(fileName);
+
+   if (! file.open(QIODevice::WriteOnly)) {
+      err("Unable to open file for writing the profile report %s, error: %d\n", csPrintable(fileName), file.error());
+      return false;
+   }
+
+   file.write(QJsonDocument(object).toJson());
+
+   return true;
+}
@@ -21,12 +21,15 @@
 
 #include <QByteArray>
 #include <QCache>
+#include <QElapsedTimer>
 #include <QHash>
+#include <QJsonObject>
 #include <QMultiHash>
 #include <QList>
 #include <QString>
 #include <QSharedPointer>
 #include <QTime>
+#include <QVector>
 
 #include <classlist.h>
 #include <cite.h>
@@ -69,19 +72,51 @@ class StringDict : public QHash<QString, QString>
    {}
 };
 
+/** Collects timing information for the phases of a DoxyPress run
+ *
+ *  Each begin() / end() pair records the wall clock time, cpu time and the growth of the peak
+ *  memory usage. Phases can be nested, phases with the same name and parent are accumulated.
+ */
 class Statistics
 {
  public:
-   Statistics()
-   {}
-
-   void begin(const QString &name) {
-      msg(name);
-   }
-
-   void end() {
-   }
-
+   Statistics();
+
+   // quiet is used for sub phases which should not be shown as progress messages
+   void begin(const QString &name, bool quiet = false);
+   void end();
+
+   void print();
+   bool writeReport(const QString &fileName);
+
+ private:
+   struct Phase {
+      QString name;
+      int     parent;
+      int     count;
+
+      qint64  wallTime;            // nano seconds
+      qint64  cpuTime;             // nano seconds
+      qint64  peakMemory;          // bytes the peak memory grew while this phase was active
+
+      QVector<int> children;
+   };
+
+   struct Frame {
+      int     phase;
+      qint64  wallStart;
+      qint64  cpuStart;
+      qint64  memoryStart;
+   };
+
+   void finish();
+   void printPhase(int index, int depth, qint64 totalTime);
+   QJsonObject phaseToJson(int index);
+   QVector<int> sortedChildren(int index);
+
+   QElapsedTimer  m_timer;
+   QVector<Phase> m_phases;
+   QVector<Frame> m_stack;
 };
 
 namespace Doxy_Work{
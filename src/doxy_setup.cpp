@@ -54,6 +54,7 @@
 #include <portable.h>
 #include <pre.h>
 #include <rtfgen.h>
+#include <trace.h>
 #include <util.h>
 
 namespace Doxy_Setup {
@@ -72,6 +73,7 @@ enum Options {
      DATETIME,
      HELP,
      OUTPUT_APP,
+     TRACE,
      DVERSION,
 };
 
@@ -157,6 +159,7 @@ CommandLine parseCommandLine(QStringList argList)
 
    argMap.insert( "--dt",       DATETIME        );
    argMap.insert( "--help",     HELP            );
+   argMap.insert( "--trace",    TRACE           );
    argMap.insert( "--version",  DVERSION        );
 
    QStringList dashList;
@@ -355,6 +358,17 @@ CommandLine parseCommandLine(QStringList argList)
             cmdArgs.dateTimeStr = getValue(iter, argList.end());
             break;
 
+         case TRACE:
+            cmdArgs.traceName = getValue(iter, argList.end());
+
+            if (cmdArgs.traceName.isEmpty() ) {
+               err("Option \"--trace\" is missing a file name\n");
+               Doxy_Work::stopDoxyPress();
+            }
+
+            Trace::start(cmdArgs.traceName);
+            break;
+
          case HELP:
             usage();
             exit(0);
@@ -687,6 +701,10 @@ void Doxy_Setup::usage()
    printf("Use passed date/time value in the output footer (yyyy/MM/dd HH:mm:ss):\n");
    printf("   --dt <date_time>          Default is the current system date and time\n");
 
+   printf("\n");
+   printf("Write a Chrome trace event file showing the time spent per input file and output page:\n");
+   printf("   --trace <file name>\n");
+
    printf("\n");
    printf("Other Options:\n");
    printf("   -b      turns off output buffering of displayed messages\n");
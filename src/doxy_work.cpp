@@ -16,14 +16,21 @@
 *
 *************************************************************************/
 
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QWaitCondition>
+
 #include <errno.h>
 #include <locale.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <memory>
 #include <set>
 
 #include <arguments.h>
+#include <chunkedbuffer.h>
 #include <cite.h>
 #include <cmdmapper.h>
 #include <code_cstyle.h>
@@ -41,6 +48,7 @@
 #include <doxy_globals.h>
 #include <eclipsehelp.h>
 #include <entry.h>
+#include <entrycache.h>
 #include <formula.h>
 #include <ftvhelp.h>
 #include <groupdef.h>
@@ -48,6 +56,7 @@
 #include <htmlgen.h>
 #include <htmlhelp.h>
 #include <index.h>
+#include <inputfilter.h>
 #include <language.h>
 #include <latexgen.h>
 #include <layout.h>
@@ -55,6 +64,7 @@
 #include <mangen.h>
 #include <msc.h>
 #include <objcache.h>
+#include <outputcache.h>
 #include <outputlist.h>
 #include <parse_base.h>
 #include <parse_clang.h>
@@ -65,7 +75,9 @@
 #include <pre.h>
 #include <qhp.h>
 #include <rtfgen.h>
+#include <sourcecache.h>
 #include <tagreader.h>
+#include <trace.h>
 #include <util.h>
 #include <xmlgen.h>
 
@@ -207,6 +219,10 @@ static STLInfo g_stlinfo[] = {
    { 0,                      0,                              0,                     0,             0,             0,     0,             false,   false }
 };
 
+class DirectoryCrawler;
+
+static int parseThreadCount();
+
 namespace Doxy_Work{
 
    void addClassToContext(QSharedPointer<Entry> ptrEntry);
@@ -378,7 +394,8 @@ namespace Doxy_Work{
    void organizeSubGroups(QSharedPointer<Entry> ptrEntry);
 
    void parseFile(ParserInterface *parser, QSharedPointer<Entry> ptrEntry,
-                  QSharedPointer<FileDef> fd, QString fileName, enum ParserMode mode, QStringList &filesInSameTu);
+                  QSharedPointer<FileDef> fd, QString fileName, enum ParserMode mode, QStringList &filesInSameTu,
+                  const QString *fileBuffer = nullptr, bool isConverted = false);
 
    void parseFiles(QSharedPointer<Entry> ptrEntry);
 
@@ -390,8 +407,9 @@ struct ReadDirArgs {
    bool recursive       = false;
    bool errorIfNotExist = true;
 
-   QStringList includePatternList;
-   QStringList excludePatternList;
+   // compiled once, matched against every file found
+   PatternMatcher includePatternList;
+   PatternMatcher excludePatternList;
 
    QSet<QString> excludeSet;
 
@@ -412,6 +430,9 @@ struct ReadDirArgs {
 
    bool isPathSet = false;
    QSet<QString> pathSet;
+
+   // directory listings read ahead by worker threads
+   DirectoryCrawler *crawler = nullptr;
 };
 
    void readFileOrDirectory(const QString &fileName, ReadDirArgs &data);
@@ -573,6 +594,9 @@ void processFiles()
    Config::setList("exclude-patterns", exclPatterns);
    searchInputFiles();
 
+   // file versions are read while the input is parsed
+   FileDef::startVersionFilter(parseThreadCount());
+
    // **  Note: the order of the function calls below are important
 
    if (Config::getBool("generate-html")) {
@@ -599,6 +623,7 @@ void processFiles()
    parseFiles(root);
 
    Doxy_Globals::infoLog_Stat.end();
+   EntryCache::printStatistics();
 
    // done with input scanning, free up the buffers used by lex (can be around 4MB)
    preFreeScanner();
@@ -684,6 +709,7 @@ void processFiles()
    // UNO IDL
    Doxy_Globals::infoLog_Stat.begin("Building interface member list\n");
    buildInterfaceAndServiceList(root);
+   Doxy_Globals::infoLog_Stat.end();
 
    // using class info only
    Doxy_Globals::infoLog_Stat.begin("Building member list\n");
@@ -877,6 +903,9 @@ void generateOutput()
    // add extra languages for which we can only produce syntax highlighted code
    addCodeOnlyMappings();
 
+   // determine which pages did not change since the last run
+   OutputCache::initialize();
+
    const bool generateHtml        = Config::getBool("generate-html");
    const bool generateDocbook     = Config::getBool("generate-docbook");
    const bool generateLatex       = Config::getBool("generate-latex");
@@ -925,10 +954,13 @@ void generateOutput()
 
       Doxy_Globals::indexList.initialize();
       HtmlGenerator::writeTabData();
+
+      Doxy_Globals::infoLog_Stat.end();
    }
 
    if (generateDocbook) {
       Doxy_Globals::infoLog_Stat.begin("Enable Docbook output\n");
+      Doxy_Globals::infoLog_Stat.end();
    }
 
    if (generateLatex) {
@@ -936,6 +968,8 @@ void generateOutput()
 
       Doxy_Globals::outputList.add(QMakeShared<LatexGenerator>());
       LatexGenerator::init();
+
+      Doxy_Globals::infoLog_Stat.end();
    }
 
    if (generateMan) {
@@ -943,10 +977,13 @@ void generateOutput()
 
       Doxy_Globals::outputList.add(QMakeShared<ManGenerator>());
       ManGenerator::init();
+
+      Doxy_Globals::infoLog_Stat.end();
    }
 
    if (generatePerl) {
       Doxy_Globals::infoLog_Stat.begin("Enable Perl output\n");
+      Doxy_Globals::infoLog_Stat.end();
    }
 
    if (generateRtf) {
@@ -956,10 +993,13 @@ void generateOutput()
       RTFGenerator::init();
 
       copyLogo(rtfOutput);
+
+      Doxy_Globals::infoLog_Stat.end();
    }
 
    if (generateXml) {
       Doxy_Globals::infoLog_Stat.begin("Enable XML output\n");
+      Doxy_Globals::infoLog_Stat.end();
    }
 
    if (Config::getBool("use-htags")) {
@@ -1081,6 +1121,9 @@ void generateOutput()
       writeIndexHierarchy(Doxy_Globals::outputList);
    }
 
+   // pages written by the generators must be on disk before any post processing
+   OutputGenerator::waitForFiles();
+
    Doxy_Globals::infoLog_Stat.begin("Finalizing index pages\n");
    Doxy_Globals::indexList.finalize();
    Doxy_Globals::infoLog_Stat.end();
@@ -1155,6 +1198,9 @@ void generateOutput()
       Doxy_Globals::infoLog_Stat.end();
    }
 
+   // search pages are written through the generators as well
+   OutputGenerator::waitForFiles();
+
    if (generateRtf) {
       Doxy_Globals::infoLog_Stat.begin("Post process RTF output\n");
 
@@ -1234,6 +1280,22 @@ void generateOutput()
    }
 
    msg("Lookup cache used %d/%d \n", Doxy_Globals::lookupCache.count(), Doxy_Globals::lookupCache.size());
+   SourceCache::printStatistics();
+   InputFilter::printStatistics();
+
+   if (Debug::isFlagSet(Debug::Time)) {
+      Doxy_Globals::infoLog_Stat.print();
+   }
+
+   const QString profileReport = Config::getString("profile-report");
+
+   if (! profileReport.isEmpty()) {
+      Doxy_Globals::infoLog_Stat.writeReport(profileReport);
+   }
+
+   Trace::finish();
+   OutputCache::finish();
+
    msg("Finished\n");
 
    // all done, cleaning up and exit
@@ -8284,27 +8346,216 @@ void Doxy_Work::buildCompleteMemberLists()
    }
 }
 
+// number of worker threads used to read input, 0 in the config file selects the number of cores
+static int parseThreadCount()
+{
+   int retval = qMin(32, Config::getInt("parse-num-threads"));
+
+   if (retval == 0) {
+      retval = qMax(2, QThread::idealThreadCount());
+   }
+
+   return retval;
+}
+
+/** Reads input files ahead of the scanners using a pool of worker threads. The lex scanners
+ *  and the preprocessor keep their state in static variables, so only loading, filtering and
+ *  transcoding is done concurrently. Files are handed out strictly in input order.
+ */
+class InputFilePrefetch
+{
+ public:
+   InputFilePrefetch(const QStringList &fileList, int numThreads, bool filter = false, bool isSourceCode = false);
+   ~InputFilePrefetch();
+
+   // returns the contents of the file at index, waits until the file was read
+   // isRead is false when no worker thread is running and the caller has to read the file,
+   // a file which could not be read was already reported and is returned empty
+   QString take(int index, bool &isRead);
+
+ private:
+   class Worker : public QThread
+   {
+    public:
+      Worker(InputFilePrefetch *owner)
+         : m_owner(owner)
+      { }
+
+      void run() override {
+         m_owner->work();
+      }
+
+    private:
+      InputFilePrefetch *m_owner;
+   };
+
+   void work();
+
+   const QStringList m_fileList;
+   const bool m_filter;
+   const bool m_isSourceCode;
+
+   QVector<QString> m_contents;
+   QVector<int>     m_status;          // 0 pending, 1 read, -1 failed
+
+   int  m_nextIndex;
+   int  m_consumed;
+   int  m_window;
+   bool m_stop;
+
+   QMutex          m_mutex;
+   QWaitCondition  m_fileReady;
+   QWaitCondition  m_slotFree;
+
+   QList<Worker *> m_workers;
+};
+
+InputFilePrefetch::InputFilePrefetch(const QStringList &fileList, int numThreads, bool filter, bool isSourceCode)
+   : m_fileList(fileList), m_filter(filter), m_isSourceCode(isSourceCode),
+     m_contents(fileList.count()), m_status(fileList.count(), 0),
+     m_nextIndex(0), m_consumed(0), m_window(numThreads * 4), m_stop(false)
+{
+   for (int i = 0; i < numThreads; ++i) {
+      Worker *thread = new Worker(this);
+      thread->start();
+
+      if (thread->isRunning()) {
+         m_workers.append(thread);
+      } else {
+         // no more threads available
+         delete thread;
+      }
+   }
+}
+
+InputFilePrefetch::~InputFilePrefetch()
+{
+   {
+      QMutexLocker locker(&m_mutex);
+      m_stop = true;
+      m_slotFree.wakeAll();
+   }
+
+   for (auto thread : m_workers) {
+      thread->wait();
+      delete thread;
+   }
+}
+
+void InputFilePrefetch::work()
+{
+   while (true) {
+      int index;
+
+      {
+         QMutexLocker locker(&m_mutex);
+
+         // limit how far the workers are allowed to get ahead of the scanner
+         while (! m_stop && m_nextIndex < m_fileList.count() && m_nextIndex >= m_consumed + m_window) {
+            m_slotFree.wait(&m_mutex);
+         }
+
+         if (m_stop || m_nextIndex >= m_fileList.count()) {
+            return;
+         }
+
+         index = m_nextIndex;
+         ++m_nextIndex;
+      }
+
+      QString fileContents;
+      bool ok = readInputFile(m_fileList.at(index), fileContents, m_filter, m_isSourceCode);
+
+      QMutexLocker locker(&m_mutex);
+
+      m_contents[index] = std::move(fileContents);
+      m_status[index]   = ok ? 1 : -1;
+
+      m_fileReady.wakeAll();
+   }
+}
+
+QString InputFilePrefetch::take(int index, bool &isRead)
+{
+   QMutexLocker locker(&m_mutex);
+
+   if (m_workers.isEmpty()) {
+      isRead = false;
+      return QString();
+   }
+
+   while (m_status[index] == 0) {
+      m_fileReady.wait(&m_mutex);
+   }
+
+   QString retval = std::move(m_contents[index]);
+   m_contents[index].clear();
+
+   isRead = true;
+
+   if (index + 1 > m_consumed) {
+      m_consumed = index + 1;
+      m_slotFree.wakeAll();
+   }
+
+   return retval;
+}
+
 void Doxy_Work::generateSourceCode()
 {
    if (Doxy_Globals::inputNameList.count() > 0) {
       static bool clangParsing = Config::getBool("clang-parsing");
 
       if (clangParsing) {
+         static const bool filterSourceFiles = Config::getBool("filter-source-files");
+
          QSet<QString> processedFiles;
          QSet<QString> filesToProcess;
 
+         QStringList sourceNames;
+
          for (auto &fn : Doxy_Globals::inputNameList) {
             for (auto fd : *fn) {
                filesToProcess.insert(fd->getFilePath());
+
+               if (fd->isSource() && ! fd->isReference()) {
+                  sourceNames.append(fd->getFilePath());
+               }
             }
          }
 
+         int numThreads = parseThreadCount();
+
+         if (numThreads <= 1 || sourceNames.count() < 2) {
+            numThreads = 0;
+         } else {
+            msg("Reading source files using %d parallel threads\n", numThreads);
+         }
+
+         // source files are read and filtered concurrently, clang consumes them in order
+         InputFilePrefetch prefetch(sourceNames, numThreads, filterSourceFiles, true);
+         int sourceIndex = 0;
+
          // process source files (and their include dependencies)
          for (auto &fn : Doxy_Globals::inputNameList) {
 
             for (auto fd : *fn) {
                if (fd->isSource() && ! fd->isReference()) {
                   QStringList includeFiles;
+                  QString fileBuffer;
+                  bool isRead = false;
+
+                  if (numThreads > 0) {
+                     Doxy_Globals::infoLog_Stat.begin("Waiting for source files", true);
+                     fileBuffer = prefetch.take(sourceIndex, isRead);
+                     Doxy_Globals::infoLog_Stat.end();
+
+                     if (! fileBuffer.isEmpty() && ! fileBuffer.endsWith('\n')) {
+                        fileBuffer += '\n';
+                     }
+                  }
+
+                  ++sourceIndex;
 
                   fd->getAllIncludeFilesRecursively(includeFiles);
                   fd->startParsing();
@@ -8313,13 +8564,13 @@ void Doxy_Work::generateSourceCode()
                      // source needs to be shown in the output
 
                      msg("Generating code for file %s\n", csPrintable(fd->docName()));
-                     fd->writeSource(Doxy_Globals::outputList, false, includeFiles);
+                     fd->writeSource(Doxy_Globals::outputList, false, includeFiles, isRead ? &fileBuffer : nullptr);
 
                   } else if (! fd->isReference() && Doxy_Globals::parseSourcesNeeded) {
                      // parse the source even if not shown
 
                      msg("Parsing code for file %s\n", csPrintable(fd->docName()));
-                     fd->parseSource(false, includeFiles);
+                     fd->parseSource(false, includeFiles, isRead ? &fileBuffer : nullptr);
                   }
 
                   for (QString incFile : includeFiles) {
@@ -8383,30 +8634,69 @@ void Doxy_Work::generateSourceCode()
             }
          }
 
+         ClangParser::instance()->removeSavedUnits();
+
       } else {
          // use lex and not clang
+         static const bool filterSourceFiles = Config::getBool("filter-source-files");
+
+         int numThreads = parseThreadCount();
+
+         QList<QSharedPointer<FileDef>> fileList;
+         QStringList fileNames;
 
          for (auto &fn : Doxy_Globals::inputNameList) {
 
-           for (auto fd : *fn) {
-               QStringList includeFiles;
-               fd->startParsing();
+            for (auto fd : *fn) {
+               if (fd->generateSourceFile() || (! fd->isReference() && Doxy_Globals::parseSourcesNeeded)) {
+                  fileList.append(fd);
+                  fileNames.append(fd->getFilePath());
+               }
+            }
+         }
 
-               if (fd->generateSourceFile()) {
-                  // source needs to be shown in the output
-                  msg("Generating code for file %s\n", csPrintable(fd->docName()));
+         if (numThreads <= 1 || fileList.count() < 2) {
+            numThreads = 0;
+         } else {
+            msg("Reading source files using %d parallel threads\n", numThreads);
+         }
+
+         // source files are read and filtered concurrently, the code scanner consumes them in order
+         InputFilePrefetch prefetch(fileNames, numThreads, filterSourceFiles, true);
+
+         for (int i = 0; i < fileList.count(); ++i) {
+            QSharedPointer<FileDef> fd = fileList[i];
 
-                  fd->writeSource(Doxy_Globals::outputList, false, includeFiles);
+            QStringList includeFiles;
+            QString fileBuffer;
+            bool isRead = false;
 
-               } else if (! fd->isReference() && Doxy_Globals::parseSourcesNeeded) {
-                  // parse the sources even if we do not show it
+            if (numThreads > 0) {
+               Doxy_Globals::infoLog_Stat.begin("Waiting for source files", true);
+               fileBuffer = prefetch.take(i, isRead);
+               Doxy_Globals::infoLog_Stat.end();
 
-                  msg("Parsing code for file %s\n",  csPrintable(fd->docName()));
-                  fd->parseSource(false, includeFiles);
+               if (! fileBuffer.isEmpty() && ! fileBuffer.endsWith('\n')) {
+                  fileBuffer += '\n';
                }
+            }
+
+            fd->startParsing();
+
+            if (fd->generateSourceFile()) {
+               // source needs to be shown in the output
+               msg("Generating code for file %s\n", csPrintable(fd->docName()));
 
-               fd->finishParsing();
+               fd->writeSource(Doxy_Globals::outputList, false, includeFiles, isRead ? &fileBuffer : nullptr);
+
+            } else {
+               // parse the sources even if we do not show it
+
+               msg("Parsing code for file %s\n",  csPrintable(fd->docName()));
+               fd->parseSource(false, includeFiles, isRead ? &fileBuffer : nullptr);
             }
+
+            fd->finishParsing();
          }
       }
    }
@@ -8425,9 +8715,10 @@ void Doxy_Work::generateFileDocs()
          for (auto fd : *fn) {
             bool doc = fd->isLinkableInProject();
 
-            if (doc) {
+            if (doc && ! OutputCache::isUpToDate(fd)) {
                msg("Generating docs for file %s\n", csPrintable(fd->docName()));
                fd->writeDocumentation(Doxy_Globals::outputList);
+               OutputCache::endPage();
             }
          }
       }
@@ -8491,11 +8782,12 @@ void Doxy_Work::generateClassList(ClassSDict &classSDict)
 
          // skip external references, anonymous compounds and template instances
 
-         if ( cd->isLinkableInProject() && cd->templateMaster() == 0) {
+         if (cd->isLinkableInProject() && cd->templateMaster() == 0 && ! OutputCache::isUpToDate(cd)) {
             msg("Generating docs for compound %s\n", csPrintable(cd->name()));
 
             cd->writeDocumentation(Doxy_Globals::outputList);
             cd->writeMemberList(Doxy_Globals::outputList);
+            OutputCache::endPage();
          }
 
          // even for undocumented classes, the inner classes can be documented.
@@ -9127,12 +9419,14 @@ void Doxy_Work::generatePageDocs()
 
    for (auto &pd : Doxy_Globals::pageSDict) {
 
-      if (! pd->getGroupDef() && ! pd->isReference()) {
+      if (! pd->getGroupDef() && ! pd->isReference() && ! OutputCache::isUpToDate(pd)) {
          msg("Generating docs for page %s\n", csPrintable(pd->name()));
 
          Doxy_Globals::insideMainPage = true;
          pd->writeDocumentation(Doxy_Globals::outputList);
          Doxy_Globals::insideMainPage = false;
+
+         OutputCache::endPage();
       }
    }
 }
@@ -9212,9 +9506,10 @@ void Doxy_Work::generateExampleDocs()
 void Doxy_Work::generateGroupDocs()
 {
    for (auto gd : Doxy_Globals::groupSDict) {
-      if (! gd->isReference()) {
+      if (! gd->isReference() && ! OutputCache::isUpToDate(gd)) {
          msg("Generating docs for group %s\n", csPrintable(gd->name()) );
          gd->writeDocumentation(Doxy_Globals::outputList);
+         OutputCache::endPage();
       }
    }
 }
@@ -9240,15 +9535,17 @@ void Doxy_Work::generateNamespaceDocs()
    // for each namespace
    for (auto &nd : Doxy_Globals::namespaceSDict) {
 
-      if (nd->isLinkableInProject()) {
+      if (nd->isLinkableInProject() && ! OutputCache::isUpToDate(nd)) {
          msg("Generating docs for namespace %s\n", csPrintable(nd->name()));
          nd->writeDocumentation(Doxy_Globals::outputList);
+         OutputCache::endPage();
       }
 
       // for each class in the namespace
       for (auto cd : nd->getClassSDict()) {
 
-         if ( (cd->isLinkableInProject() && cd->templateMaster() == nullptr) && ! cd->isHidden() && ! cd->isEmbeddedInOuterScope() ) {
+         if ( (cd->isLinkableInProject() && cd->templateMaster() == nullptr) && ! cd->isHidden() && ! cd->isEmbeddedInOuterScope()
+               && ! OutputCache::isUpToDate(cd)) {
               // skip external references, anonymous compounds and
               // template instances and nested classes
 
@@ -9256,6 +9553,7 @@ void Doxy_Work::generateNamespaceDocs()
 
             cd->writeDocumentation(Doxy_Globals::outputList);
             cd->writeMemberList(Doxy_Globals::outputList);
+            OutputCache::endPage();
          }
 
          cd->writeDocumentationForInnerClasses(Doxy_Globals::outputList);
@@ -9420,12 +9718,104 @@ static ParserInterface *getParserForFile(const QString &fn)
    return Doxy_Globals::parserManager.getParser(extension);
 }
 
+/** Converts the comments of a file in a separate thread while the preprocessor is still
+ *  producing the input. The preprocessor passes its output on through a ChunkedBuffer, so the
+ *  complete preprocessed file is never held in memory twice. One thread converts all files.
+ */
+class CommentConverter : public QThread
+{
+ public:
+   CommentConverter()
+      : m_input(nullptr), m_done(false), m_stop(false)
+   {
+      start();
+   }
+
+   ~CommentConverter() {
+      {
+         QMutexLocker locker(&m_mutex);
+         m_stop = true;
+         m_jobReady.wakeAll();
+      }
+
+      wait();
+   }
+
+   // starts converting the text which is passed through input
+   void begin(ChunkedBuffer &input, const QString &fileName) {
+      QMutexLocker locker(&m_mutex);
+
+      m_input    = &input;
+      m_fileName = fileName;
+      m_done     = false;
+
+      m_jobReady.wakeAll();
+   }
+
+   // waits until the input was closed and converted, returns the result
+   QString finish() {
+      QMutexLocker locker(&m_mutex);
+
+      while (! m_done) {
+         m_jobDone.wait(&m_mutex);
+      }
+
+      m_input = nullptr;
+
+      return std::move(m_output);
+   }
+
+   void run() override {
+      QMutexLocker locker(&m_mutex);
+
+      while (true) {
+         while ((m_input == nullptr || m_done) && ! m_stop) {
+            m_jobReady.wait(&m_mutex);
+         }
+
+         if (m_stop) {
+            return;
+         }
+
+         ChunkedBuffer *input = m_input;
+         QString fileName     = m_fileName;
+
+         locker.unlock();
+         QString output = convertCppComments(*input, fileName);
+         locker.relock();
+
+         m_output = std::move(output);
+         m_done   = true;
+
+         m_jobDone.wakeAll();
+      }
+   }
+
+ private:
+   ChunkedBuffer *m_input;
+   QString m_fileName;
+   QString m_output;
+
+   bool m_done;
+   bool m_stop;
+
+   QMutex         m_mutex;
+   QWaitCondition m_jobReady;
+   QWaitCondition m_jobDone;
+};
+
+// converter thread used by parseFile(), only set while parseFiles() preprocesses the input
+static CommentConverter *s_commentConverter = nullptr;
+
 void Doxy_Work::parseFile(ParserInterface *parser, QSharedPointer<Entry> root,
-      QSharedPointer<FileDef> fd, QString fileName, enum ParserMode mode, QStringList &includedFiles)
+      QSharedPointer<FileDef> fd, QString fileName, enum ParserMode mode, QStringList &includedFiles,
+      const QString *fileBuffer, bool isConverted)
 {
    static const bool clangParsing        = Config::getBool("clang-parsing");
    static const bool enablePreprocessing = Config::getBool("enable-preprocessing");
 
+   Trace::Scope trace("parse", fileName);
+
    QString extension;
    int ei = fileName.lastIndexOf('.');
 
@@ -9437,31 +9827,117 @@ void Doxy_Work::parseFile(ParserInterface *parser, QSharedPointer<Entry> root,
 
    QFileInfo fi(fileName);
    QString fileContents;
+   QString buffer;
+
+   bool isRead = (fileBuffer != nullptr);
+
+   if (isRead) {
+      // file was already read by a prefetch thread
+      fileContents = *fileBuffer;
+   }
+
+   auto srcLang = fd->getLanguage();
+
+   bool useClang   = clangParsing && (srcLang == SrcLangExt_Cpp || srcLang == SrcLangExt_ObjC);
+   bool preprocess = ! clangParsing && enablePreprocessing && parser->needsPreprocessing(extension);
+
+   // entries from the parse cache replace preprocessing, converting and scanning the file
+   bool useCache = EntryCache::isEnabled() && ! useClang;
+
+   QByteArray cacheKey;
+   EntryCache::GlobalState oldState;
+   int firstChild = 0;
+
+   if (useCache) {
+      if (! isRead) {
+         Doxy_Globals::infoLog_Stat.begin("Reading input files", true);
+         fileContents = readInputFile(fileName);
+         Doxy_Globals::infoLog_Stat.end();
+
+         isRead = true;
+      }
+
+      cacheKey = EntryCache::cacheKey(fileName, fileContents, srcLang, mode);
+      QVector<QSharedPointer<Entry>> entryList;
 
-   if (! clangParsing && enablePreprocessing && parser->needsPreprocessing(extension)) {
+      if (EntryCache::load(fileName, cacheKey, entryList) && (! preprocess || replayPreprocessFile(fileName, fileContents))) {
+         msg("Reading %s from the parse cache\n", csPrintable(fileName));
+
+         EntryCache::addEntries(root, entryList);
+         root->createNavigationIndex(fd);
+
+         return;
+      }
+
+      oldState   = EntryCache::globalState();
+      firstChild = root->children().count();
+   }
+
+   if (preprocess) {
       msg("Processing %s\n", csPrintable(fileName));
 
-      fileContents = readInputFile(fileName);
-      fileContents = preprocessFile(fileName, fileContents);
+      if (! isRead) {
+         Doxy_Globals::infoLog_Stat.begin("Reading input files", true);
+         fileContents = readInputFile(fileName);
+         Doxy_Globals::infoLog_Stat.end();
+      }
+
+      // the comment converter consumes the preprocessor output while it is produced
+      Doxy_Globals::infoLog_Stat.begin("Preprocessing and converting comments", true);
+
+      std::unique_ptr<CommentConverter> localConverter;
+      CommentConverter *converter = s_commentConverter;
+
+      if (converter == nullptr) {
+         localConverter.reset(new CommentConverter);
+         converter = localConverter.get();
+      }
+
+      ChunkedBuffer chunks;
+      converter->begin(chunks, fileName);
+
+      preprocessFile(fileName, fileContents, &chunks);
+      chunks.close();
+
+      buffer = converter->finish();
+
+      Doxy_Globals::infoLog_Stat.end();
+
+   } else if (isConverted) {
+      // comments were converted before the file was passed to the clang worker threads
+      msg("Reading %s\n", csPrintable(fileName));
+      buffer = std::move(fileContents);
 
    } else {
       // no preprocessing, if clang processing this branch is forced
       msg("Reading %s\n", csPrintable(fileName));
-      fileContents = readInputFile(fileName);
-   }
 
-   if (! fileContents.endsWith("\n")) {
-      // add extra newline to help parser
-      fileContents += '\n';
+      if (! isRead) {
+         Doxy_Globals::infoLog_Stat.begin("Reading input files", true);
+         fileContents = readInputFile(fileName);
+         Doxy_Globals::infoLog_Stat.end();
+      }
+
+      if (! fileContents.endsWith("\n")) {
+         // add extra newline to help parser
+         fileContents += '\n';
+      }
+
+      // convert multi-line C++ comments to C style comments
+      Doxy_Globals::infoLog_Stat.begin("Converting comments", true);
+      buffer = convertCppComments(fileContents, fileName);
+      Doxy_Globals::infoLog_Stat.end();
    }
 
-   // convert multi-line C++ comments to C style comments
-   QString buffer = convertCppComments(fileContents, fileName);
-   auto srcLang   = fd->getLanguage();
+   Doxy_Globals::infoLog_Stat.begin("Scanning", true);
 
-   if (clangParsing && (srcLang == SrcLangExt_Cpp || srcLang == SrcLangExt_ObjC)) {
+   if (useClang) {
       fd->getAllIncludeFilesRecursively(includedFiles);
 
+      if (! isConverted) {
+         ClangParser::instance()->setUnconverted(buffer == fileContents);
+      }
+
       // use clang for parsing
       parser->parseInput(fileName, buffer, root, mode, includedFiles, true);
 
@@ -9469,8 +9945,13 @@ void Doxy_Work::parseFile(ParserInterface *parser, QSharedPointer<Entry> root,
       // use lex for parser
       parser->parseInput(fileName, buffer, root, mode, includedFiles, false);
 
+      if (useCache) {
+         EntryCache::store(fileName, cacheKey, root, firstChild, oldState);
+      }
    }
 
+   Doxy_Globals::infoLog_Stat.end();
+
    // add fileDef to the child entries
    root->createNavigationIndex(fd);
 }
@@ -9489,6 +9970,34 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
          filesToProcess.insert(fName);
       }
 
+      // source files are parsed by clang on worker threads ahead of the file being scanned,
+      // entries are still added one translation unit at a time in the order of the input
+      int numThreads = parseThreadCount();
+
+      QStringList sourceFiles;
+      QHash<QString, int> sourceIndexes;
+      QHash<QString, QString> convertedFiles;
+      QSet<QString> unconvertedFiles;
+      int nextPrefetch = 0;
+
+      if (numThreads > 1) {
+         ClangParser::instance()->setNumThreads(numThreads);
+
+         for (auto fName : Doxy_Globals::g_inputFiles) {
+            bool ambig;
+            QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, fName, ambig);
+
+            if (fd != nullptr && fd->isSource() && ! fd->isReference() &&
+                  (fd->getLanguage() == SrcLangExt_Cpp || fd->getLanguage() == SrcLangExt_ObjC)) {
+               sourceIndexes.insert(fName, sourceFiles.count());
+               sourceFiles.append(fName);
+            }
+         }
+      }
+
+      // source files are read on worker threads, converting the comments is not reentrant
+      InputFilePrefetch readAhead(sourceFiles, sourceFiles.isEmpty() ? 0 : numThreads);
+
       // process source files and their include dependencies
       for (auto fName : Doxy_Globals::g_inputFiles) {
          bool ambig;
@@ -9501,8 +10010,61 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
 
             auto srcLang = fd->getLanguage();
 
+            int sourceIndex = sourceIndexes.value(fName, -1);
+
+            if (sourceIndex != -1) {
+               // keep the worker threads busy with the next source files
+               nextPrefetch = qMax(nextPrefetch, sourceIndex);
+
+               while (nextPrefetch < sourceFiles.count() && nextPrefetch <= sourceIndex + numThreads * 2) {
+                  QString nextName = sourceFiles[nextPrefetch];
+                  QSharedPointer<FileDef> nextFd = findFileDef(&Doxy_Globals::inputNameDict, nextName, ambig);
+
+                  bool isRead;
+
+                  Doxy_Globals::infoLog_Stat.begin("Reading input files", true);
+                  QString contents = readAhead.take(nextPrefetch, isRead);
+
+                  if (! isRead) {
+                     contents = readInputFile(nextName);
+                  }
+
+                  Doxy_Globals::infoLog_Stat.end();
+
+                  if (! contents.endsWith("\n")) {
+                     // add extra newline to help parser
+                     contents += '\n';
+                  }
+
+                  Doxy_Globals::infoLog_Stat.begin("Converting comments", true);
+                  QString converted = convertCppComments(contents, nextName);
+                  Doxy_Globals::infoLog_Stat.end();
+
+                  QStringList nextIncludes;
+                  nextFd->getAllIncludeFilesRecursively(nextIncludes);
+
+                  if (converted == contents) {
+                     unconvertedFiles.insert(nextName);
+                  }
+
+                  ClangParser::instance()->prefetch(nextName, converted, nextIncludes);
+                  convertedFiles.insert(nextName, std::move(converted));
+
+                  ++nextPrefetch;
+               }
+            }
+
             ParserInterface *parser = getParserForFile(fName);
-            parseFile(parser, root, fd, fName, ParserMode::SOURCE_FILE, includedFiles);
+
+            if (convertedFiles.contains(fName)) {
+               QString converted = convertedFiles.take(fName);
+
+               ClangParser::instance()->setUnconverted(unconvertedFiles.remove(fName));
+               parseFile(parser, root, fd, fName, ParserMode::SOURCE_FILE, includedFiles, &converted, true);
+
+            } else {
+               parseFile(parser, root, fd, fName, ParserMode::SOURCE_FILE, includedFiles);
+            }
 
             // process any include files in the the current source file
             for (auto file : includedFiles) {
@@ -9531,6 +10093,9 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
          }
       }
 
+      // stop the worker threads, any unused translation units are released
+      ClangParser::instance()->setNumThreads(0);
+
       // process remaining files, treat as source files even if they are header files
       for (auto fName : Doxy_Globals::g_inputFiles) {
 
@@ -9557,18 +10122,59 @@ void Doxy_Work::parseFiles(QSharedPointer<Entry> root)
 
    } else  {
       // use lex and not clang
+      int numThreads = parseThreadCount();
 
-      for (auto fName : Doxy_Globals::g_inputFiles) {
-         QStringList includedFiles;
+      // one thread converts the comments of all files while they are preprocessed
+      std::unique_ptr<CommentConverter> converter;
 
-         bool ambig;
+      if (Config::getBool("enable-preprocessing")) {
+         converter.reset(new CommentConverter);
+         s_commentConverter = converter.get();
+      }
 
-         QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, fName, ambig);
-         assert(fd != nullptr);
+      if (numThreads <= 1 || Doxy_Globals::g_inputFiles.count() < 2) {
+
+         for (auto fName : Doxy_Globals::g_inputFiles) {
+            QStringList includedFiles;
+
+            bool ambig;
+
+            QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, fName, ambig);
+            assert(fd != nullptr);
+
+            ParserInterface *parser = getParserForFile(fName);
+            parseFile(parser, root, fd, fName, ParserMode::SOURCE_FILE, includedFiles);
+         }
+
+      } else {
+         msg("Reading input files using %d parallel threads\n", numThreads);
+
+         // files are read concurrently, the scanners consume them in input order
+         InputFilePrefetch prefetch(Doxy_Globals::g_inputFiles, numThreads);
 
-         ParserInterface *parser = getParserForFile(fName);
-         parseFile(parser, root, fd, fName, ParserMode::SOURCE_FILE, includedFiles);
+         int index = 0;
+
+         for (auto fName : Doxy_Globals::g_inputFiles) {
+            QStringList includedFiles;
+
+            bool ambig;
+            bool isRead;
+
+            QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, fName, ambig);
+            assert(fd != nullptr);
+
+            Doxy_Globals::infoLog_Stat.begin("Waiting for input files", true);
+            QString fileContents = prefetch.take(index, isRead);
+            Doxy_Globals::infoLog_Stat.end();
+
+            ++index;
+
+            ParserInterface *parser = getParserForFile(fName);
+            parseFile(parser, root, fd, fName, ParserMode::SOURCE_FILE, includedFiles, isRead ? &fileContents : nullptr);
+         }
       }
+
+      s_commentConverter = nullptr;
    }
 }
 
@@ -9714,6 +10320,204 @@ QString Doxy_Work::createOutputDirectory(const QString &baseDirName, const QStri
    return formatDirName;
 }
 
+/** Lists a directory tree using a pool of worker threads before it is processed by readDir()
+ *
+ *  Workers list directories and query the file attributes readDir() needs, the results are cached
+ *  in each QFileInfo. Listings are keyed by the same resolved path readDir() uses and are returned
+ *  in QDir order, so the files are added in the same order as a serial search. The symlink loop
+ *  detection stays in readDir(), the crawler lists each resolved directory once.
+ */
+class DirectoryCrawler
+{
+ public:
+   DirectoryCrawler(const Doxy_Work::ReadDirArgs &data, int numThreads);
+
+   // lists the tree below fi, returns when all directories were read
+   void crawl(const QFileInfo &fi);
+
+   // returns false if dirName was not listed by the crawler
+   bool entryInfoList(const QString &dirName, QFileInfoList &list) const;
+
+ private:
+   class Worker : public QThread
+   {
+    public:
+      Worker(DirectoryCrawler *owner)
+         : m_owner(owner)
+      { }
+
+      void run() override {
+         m_owner->work();
+      }
+
+    private:
+      DirectoryCrawler *m_owner;
+   };
+
+   void work();
+   QFileInfoList listDir(const QString &dirName, QStringList &subDirs) const;
+
+   const Doxy_Work::ReadDirArgs &m_data;
+   const int m_numThreads;
+
+   QQueue<QString> m_queue;
+   QSet<QString>   m_queued;
+   QHash<QString, QFileInfoList> m_listings;
+
+   int m_active;
+
+   mutable QMutex  m_mutex;
+   QWaitCondition  m_stateChanged;
+};
+
+DirectoryCrawler::DirectoryCrawler(const Doxy_Work::ReadDirArgs &data, int numThreads)
+   : m_data(data), m_numThreads(numThreads), m_active(0)
+{
+}
+
+void DirectoryCrawler::crawl(const QFileInfo &fi)
+{
+   QString dirName = fi.absoluteFilePath();
+
+   if (fi.isSymLink()) {
+      dirName = Doxy_Work::resolveSymlink(dirName);
+
+      if (dirName.isEmpty()) {
+         return;
+      }
+   }
+
+   m_queue.enqueue(dirName);
+   m_queued.insert(dirName);
+
+   QList<Worker *> workers;
+
+   for (int i = 0; i < m_numThreads; ++i) {
+      Worker *thread = new Worker(this);
+      thread->start();
+
+      if (thread->isRunning()) {
+         workers.append(thread);
+      } else {
+         // no more threads available
+         delete thread;
+      }
+   }
+
+   if (workers.isEmpty()) {
+      // list on this thread
+      work();
+   }
+
+   for (auto thread : workers) {
+      thread->wait();
+      delete thread;
+   }
+}
+
+void DirectoryCrawler::work()
+{
+   while (true) {
+      QString dirName;
+
+      {
+         QMutexLocker locker(&m_mutex);
+
+         while (m_queue.isEmpty() && m_active > 0) {
+            m_stateChanged.wait(&m_mutex);
+         }
+
+         if (m_queue.isEmpty()) {
+            // no directories left and no worker can add more
+            m_stateChanged.wakeAll();
+            return;
+         }
+
+         dirName = m_queue.dequeue();
+         ++m_active;
+      }
+
+      QStringList subDirs;
+      QFileInfoList list = listDir(dirName, subDirs);
+
+      QMutexLocker locker(&m_mutex);
+
+      m_listings.insert(dirName, list);
+
+      for (auto &item : subDirs) {
+         if (! m_queued.contains(item)) {
+            m_queued.insert(item);
+            m_queue.enqueue(item);
+         }
+      }
+
+      --m_active;
+      m_stateChanged.wakeAll();
+   }
+}
+
+QFileInfoList DirectoryCrawler::listDir(const QString &dirName, QStringList &subDirs) const
+{
+   static const bool excludeSymlink = Config::getBool("exclude-symlinks");
+
+   QDir dir(dirName);
+   dir.setFilter(QDir::Files | QDir::Dirs | QDir::Hidden);
+
+   QFileInfoList list = dir.entryInfoList();
+
+   for (auto &cfi : list) {
+      QString filePath = cfi.absoluteFilePath();
+
+      if (m_data.excludeSet.contains(filePath)) {
+         continue;
+      }
+
+      // fills the attribute cache of cfi, these are the calls made by readDir()
+      if (! cfi.exists() || ! cfi.isReadable()) {
+         continue;
+      }
+
+      if (excludeSymlink && cfi.isSymLink())  {
+         continue;
+      }
+
+      if (cfi.isFile()) {
+         cfi.size();
+
+      } else if (cfi.isDir() && m_data.recursive) {
+
+         if (cfi.fileName().at(0) == '.' || m_data.excludePatternList.match(cfi)) {
+            continue;
+         }
+
+         if (cfi.isSymLink()) {
+            filePath = Doxy_Work::resolveSymlink(filePath);
+         }
+
+         if (! filePath.isEmpty()) {
+            subDirs.append(filePath);
+         }
+      }
+   }
+
+   return list;
+}
+
+bool DirectoryCrawler::entryInfoList(const QString &dirName, QFileInfoList &list) const
+{
+   QMutexLocker locker(&m_mutex);
+
+   auto iter = m_listings.constFind(dirName);
+
+   if (iter == m_listings.constEnd()) {
+      return false;
+   }
+
+   list = iter.value();
+
+   return true;
+}
+
 // read all files matching at least one pattern in `patList' in the directory represented by `fi'
 // directory is read if the recursiveFlag is set, contents of all files is append to the input string
 
@@ -9747,7 +10551,11 @@ void Doxy_Work::readDir(const QFileInfo &fi, ReadDirArgs &data)
    int totalSize = 0;
    msg("Searching for files in directory %s\n", csPrintable(fi.absoluteFilePath()) );
 
-   const QFileInfoList list = dir.entryInfoList();
+   QFileInfoList list;
+
+   if (data.crawler == nullptr || ! data.crawler->entryInfoList(dirName, list)) {
+      list = dir.entryInfoList();
+   }
 
    for (auto &cfi : list) {
       QString filePath = cfi.absoluteFilePath();
@@ -9768,8 +10576,8 @@ void Doxy_Work::readDir(const QFileInfo &fi, ReadDirArgs &data)
 
             if (cfi.isFile()) {
 
-               bool testA = (data.includePatternList.isEmpty() || patternMatch(cfi, data.includePatternList));
-               bool testB = (! patternMatch(cfi, data.excludePatternList));
+               bool testA = (data.includePatternList.isEmpty() || data.includePatternList.match(cfi));
+               bool testB = (! data.excludePatternList.match(cfi));
 
                if (testA && testB && ! data.killDict.contains(filePath) ) {
 
@@ -9814,7 +10622,7 @@ void Doxy_Work::readDir(const QFileInfo &fi, ReadDirArgs &data)
                   continue;
                }
 
-               if (patternMatch(cfi, data.excludePatternList) ) {
+               if (data.excludePatternList.match(cfi)) {
                   continue;
                }
 
@@ -9896,7 +10704,20 @@ void Doxy_Work::readFileOrDirectory(const QString &fn, ReadDirArgs &data)
 
          } else if (fi.isDir()) {
             // readable dir
-            readDir(fi, data);
+            int numThreads = parseThreadCount();
+
+            if (numThreads > 1 && data.recursive && data.crawler == nullptr) {
+               // list the directory tree concurrently, files are added to data in the usual order
+               DirectoryCrawler crawler(data, numThreads);
+               crawler.crawl(fi);
+
+               data.crawler = &crawler;
+               readDir(fi, data);
+               data.crawler = nullptr;
+
+            } else {
+               readDir(fi, data);
+            }
          }
       }
    }
@@ -16,6 +16,8 @@
 *
 *************************************************************************/
 
+#include <QDataStream>
+
 #include <stdlib.h>
 
 #include <entry.h>
@@ -65,6 +67,7 @@ Entry::Entry(const Entry &e)
    callerGraph      = e.callerGraph;
    hidden           = e.hidden;
    artificial       = e.artificial;
+   globalDocs       = e.globalDocs;
 
    // string
    m_entryName      = e.m_entryName;
@@ -133,6 +136,7 @@ void Entry::reset()
    callerGraph      = dotCalledBy;
    hidden           = false;
    artificial       = false;
+   globalDocs       = false;
 
    localToc         = LocalToc();
 
@@ -192,3 +196,258 @@ void Entry::removeSubEntry(QSharedPointer<Entry> e)
    }
 }
 
+static void writeArgumentList(QDataStream &stream, const ArgumentList &list)
+{
+   stream << qint32(list.count());
+
+   for (const auto &arg : list) {
+      stream << arg.attrib << arg.type << arg.name << arg.array << arg.defval << arg.docs << arg.typeConstraint;
+   }
+
+   stream << list.constSpecifier << list.volatileSpecifier << list.pureSpecifier << qint32(list.refSpecifier)
+          << list.trailingReturnType << list.isDeleted;
+}
+
+static void readArgumentList(QDataStream &stream, ArgumentList &list)
+{
+   qint32 count;
+   qint32 refType;
+
+   list.clear();
+   stream >> count;
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      Argument arg;
+      stream >> arg.attrib >> arg.type >> arg.name >> arg.array >> arg.defval >> arg.docs >> arg.typeConstraint;
+
+      list.append(arg);
+   }
+
+   stream >> list.constSpecifier >> list.volatileSpecifier >> list.pureSpecifier >> refType
+          >> list.trailingReturnType >> list.isDeleted;
+
+   list.refSpecifier = static_cast<RefType>(refType);
+}
+
+void Entry::writeToStream(QDataStream &stream) const
+{
+   stream << m_tagInfo.tag_Name << m_tagInfo.tag_FileName << m_tagInfo.tag_Anchor;
+
+   writeArgumentList(stream, argList);
+   writeArgumentList(stream, typeConstr);
+
+   stream << qint32(relatesType) << qint32(virt) << qint32(protection) << qint32(mtype)
+          << qint32(groupDocType) << qint32(m_srcLang) << m_traits.toQByteArray();
+
+   // int
+   stream << qint32(section)  << qint32(initLines)   << qint32(docLine)   << qint32(briefLine)
+          << qint32(inbodyLine) << qint32(bodyLine)  << qint32(endBodyLine) << qint32(mGrpId)
+          << qint32(startLine)  << qint32(startColumn);
+
+   stream << qint32(localToc.mask()) << qint32(localToc.htmlLevel()) << qint32(localToc.latexLevel())
+          << qint32(localToc.xmlLevel()) << qint32(localToc.docbookLevel());
+
+   // bool
+   stream << referencedByRelation << referencesRelation << stat << explicitExternal << proto
+          << subGrouping << callGraph << callerGraph << hidden << artificial;
+
+   // string
+   stream << m_entryName;
+
+   stream << qint32(m_templateArgLists.count());
+
+   for (const auto &list : m_templateArgLists) {
+      writeArgumentList(stream, list);
+   }
+
+   stream << qint32(extends.count());
+
+   for (const auto &item : extends) {
+      stream << item.name << qint32(item.prot) << qint32(item.virt);
+   }
+
+   stream << qint32(m_groups.count());
+
+   for (const auto &item : m_groups) {
+      stream << item.groupname << qint32(item.pri);
+   }
+
+   stream << qint32(m_anchors.count());
+
+   for (const auto &item : m_anchors) {
+      stream << item.fileName << qint32(item.lineNr) << item.label << item.title << qint32(item.type)
+             << qint32(item.level) << item.ref;
+   }
+
+   stream << qint32(m_specialLists.count());
+
+   for (const auto &item : m_specialLists) {
+      stream << item.type << qint32(item.itemId);
+   }
+
+   // private members
+   stream << qint32(m_entryMap.count());
+
+   for (auto iter = m_entryMap.begin(); iter != m_entryMap.end(); ++iter) {
+      stream << qint32(iter.key()) << iter.value();
+   }
+
+   stream << qint32(m_sublist.count());
+
+   for (const auto &child : m_sublist) {
+      child->writeToStream(stream);
+   }
+}
+
+bool Entry::readFromStream(QDataStream &stream)
+{
+   qint32 tmpRelates;
+   qint32 tmpVirt;
+   qint32 tmpProtection;
+   qint32 tmpMtype;
+   qint32 tmpGroupDocType;
+   qint32 tmpSrcLang;
+   qint32 count;
+
+   QByteArray tmpTraits;
+
+   stream >> m_tagInfo.tag_Name >> m_tagInfo.tag_FileName >> m_tagInfo.tag_Anchor;
+
+   readArgumentList(stream, argList);
+   readArgumentList(stream, typeConstr);
+
+   stream >> tmpRelates >> tmpVirt >> tmpProtection >> tmpMtype >> tmpGroupDocType >> tmpSrcLang >> tmpTraits;
+
+   relatesType  = static_cast<RelatesType>(tmpRelates);
+   virt         = static_cast<Specifier>(tmpVirt);
+   protection   = static_cast<Protection>(tmpProtection);
+   mtype        = static_cast<MethodTypes>(tmpMtype);
+   groupDocType = static_cast<GroupDocType>(tmpGroupDocType);
+   m_srcLang    = static_cast<SrcLangExt>(tmpSrcLang);
+   m_traits     = Traits::fromQByteArray(tmpTraits);
+
+   // int
+   stream >> section >> initLines >> docLine >> briefLine >> inbodyLine >> bodyLine >> endBodyLine
+          >> mGrpId >> startLine >> startColumn;
+
+   qint32 tocMask;
+   qint32 tocLevel[LocalToc::numTocTypes];
+
+   stream >> tocMask >> tocLevel[LocalToc::Html] >> tocLevel[LocalToc::Latex]
+          >> tocLevel[LocalToc::Xml] >> tocLevel[LocalToc::Docbook];
+
+   localToc = LocalToc();
+
+   if (tocMask & (1 << LocalToc::Html)) {
+      localToc.enableHtml(tocLevel[LocalToc::Html]);
+   }
+
+   if (tocMask & (1 << LocalToc::Latex)) {
+      localToc.enableLatex(tocLevel[LocalToc::Latex]);
+   }
+
+   if (tocMask & (1 << LocalToc::Xml)) {
+      localToc.enableXml(tocLevel[LocalToc::Xml]);
+   }
+
+   if (tocMask & (1 << LocalToc::Docbook)) {
+      localToc.enableDocbook(tocLevel[LocalToc::Docbook]);
+   }
+
+   // bool
+   stream >> referencedByRelation >> referencesRelation >> stat >> explicitExternal >> proto
+          >> subGrouping >> callGraph >> callerGraph >> hidden >> artificial;
+
+   // string
+   stream >> m_entryName;
+
+   stream >> count;
+   m_templateArgLists.clear();
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      ArgumentList list;
+      readArgumentList(stream, list);
+
+      m_templateArgLists.append(list);
+   }
+
+   stream >> count;
+   extends.clear();
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QString name;
+      qint32  prot;
+      qint32  tmpVirt;
+
+      stream >> name >> prot >> tmpVirt;
+      extends.append(BaseInfo(name, static_cast<Protection>(prot), static_cast<Specifier>(tmpVirt)));
+   }
+
+   stream >> count;
+   m_groups.clear();
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QString groupName;
+      qint32  pri;
+
+      stream >> groupName >> pri;
+      m_groups.append(Grouping(groupName, static_cast<Grouping::GroupPri_t>(pri)));
+   }
+
+   stream >> count;
+   m_anchors.clear();
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QString fileName;
+      QString label;
+      QString title;
+      QString ref;
+
+      qint32 lineNr;
+      qint32 type;
+      qint32 level;
+
+      stream >> fileName >> lineNr >> label >> title >> type >> level >> ref;
+      m_anchors.append(SectionInfo(fileName, lineNr, label, title, static_cast<SectionInfo::SectionType>(type), level, ref));
+   }
+
+   stream >> count;
+   m_specialLists.clear();
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      ListItemInfo item;
+      qint32 itemId;
+
+      stream >> item.type >> itemId;
+      item.itemId = itemId;
+
+      m_specialLists.append(item);
+   }
+
+   // private members
+   stream >> count;
+   m_entryMap.clear();
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      qint32  key;
+      QString value;
+
+      stream >> key >> value;
+      m_entryMap.insert(static_cast<EntryKey>(key), value);
+   }
+
+   stream >> count;
+   m_sublist.clear();
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QSharedPointer<Entry> child = QMakeShared<Entry>();
+
+      if (! child->readFromStream(stream)) {
+         return false;
+      }
+
+      addSubEntry(child);
+   }
+
+   return stream.status() == QDataStream::Ok;
+}
@@ -31,6 +31,7 @@
 #include <section.h>
 
 class FileDef;
+class QDataStream;
 struct ListItemInfo;
 
 // stores information about an inheritance relationship
@@ -341,6 +342,10 @@ class Entry : public EnableSharedFromThis
    // restore the state of this Entry to the default value when constructed
    void reset();
 
+   // save or restore this entry and all sub entries, used by the parse cache
+   void writeToStream(QDataStream &stream) const;
+   bool readFromStream(QDataStream &stream);
+
 
    // ** methdods for EnteryKey flatMap
 
@@ -417,6 +422,7 @@ class Entry : public EnableSharedFromThis
    bool callerGraph;               // do we need to draw the caller graph ?
    bool hidden;                    // does this represent an entity that is hidden from the output
    bool artificial;                // artificially introduced item
+   bool globalDocs;                // docs use a formula or citation registered by the comment scanner
 
    QString m_entryName;            // entry name
 
@@ -0,0 +1,228 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <entrycache.h>
+
+#include <config.h>
+#include <doxy_build_info.h>
+#include <doxy_globals.h>
+#include <entry.h>
+#include <message.h>
+
+// increment when the layout of the stored data changes
+static const qint32 s_cacheFormat = 3;
+
+int EntryCache::m_hits    = 0;
+int EntryCache::m_misses  = 0;
+int EntryCache::m_skipped = 0;
+
+static bool hasEntryState(QSharedPointer<Entry> ptrEntry)
+{
+   // member groups, anchors and xref items refer to global data which is not saved with the entry
+   if (ptrEntry->mGrpId != -1 || ! ptrEntry->m_anchors.isEmpty() || ! ptrEntry->m_specialLists.isEmpty()) {
+      return true;
+   }
+
+   // set by the comment scanner, a formula or citation already known from another file does not
+   // change the size of the global lists
+   if (ptrEntry->globalDocs) {
+      return true;
+   }
+
+   for (auto child : ptrEntry->children()) {
+      if (hasEntryState(child)) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+bool EntryCache::GlobalState::operator==(const GlobalState &other) const
+{
+   return xrefLists == other.xrefLists && sections == other.sections && formulas == other.formulas &&
+          citations == other.citations && memberGroups == other.memberGroups &&
+          namespaceAliases == other.namespaceAliases;
+}
+
+bool EntryCache::isEnabled()
+{
+   static const bool retval = ! Config::getString("parse-cache-dir").isEmpty();
+   return retval;
+}
+
+QString EntryCache::cacheFileName(const QString &fileName)
+{
+   static const QString cacheDir = Config::getString("parse-cache-dir");
+   static bool dirCreated        = false;
+
+   if (! dirCreated) {
+      dirCreated = true;
+
+      QDir dir;
+
+      if (! dir.mkpath(cacheDir)) {
+         err("Unable to create parse cache directory %s\n", csPrintable(cacheDir));
+      }
+   }
+
+   // one cache file per input file, a stale entry is replaced the next time the file is stored
+   QByteArray name = QCryptographicHash::hash(QFileInfo(fileName).absoluteFilePath().toUtf8(),
+         QCryptographicHash::Sha1).toHex();
+
+   return cacheDir + "/" + QString::fromLatin1(name) + ".entry";
+}
+
+QByteArray EntryCache::cacheKey(const QString &fileName, const QString &buffer, SrcLangExt lang, ParserMode mode)
+{
+   static const QByteArray configHash = Config::getCacheChecksum();
+
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+
+   hash.addData(configHash);
+   hash.addData(versionString.toUtf8());
+   hash.addData(fileName.toUtf8());
+   hash.addData(QByteArray::number(int(lang)));
+   hash.addData(QByteArray::number(int(mode)));
+   hash.addData(buffer.toUtf8());
+
+   return hash.result();
+}
+
+bool EntryCache::load(const QString &fileName, const QByteArray &key, QVector<QSharedPointer<Entry>> &entryList)
+{
+   QFile file(cacheFileName(fileName));
+
+   if (! file.open(QIODevice::ReadOnly)) {
+      return false;
+   }
+
+   QDataStream stream(&file);
+
+   qint32 format;
+   QByteArray storedKey;
+
+   stream >> format >> storedKey;
+
+   if (format != s_cacheFormat || storedKey != key) {
+      return false;
+   }
+
+   // entries are read into a temporary list so a damaged file does not leave partial results
+   QVector<QSharedPointer<Entry>> tmpList;
+   qint32 count;
+
+   stream >> count;
+
+   for (int i = 0; i < count; ++i) {
+      QSharedPointer<Entry> ptrEntry = QMakeShared<Entry>();
+
+      if (! ptrEntry->readFromStream(stream)) {
+         return false;
+      }
+
+      tmpList.append(ptrEntry);
+   }
+
+   entryList = tmpList;
+
+   return true;
+}
+
+void EntryCache::addEntries(QSharedPointer<Entry> root, const QVector<QSharedPointer<Entry>> &entryList)
+{
+   for (auto ptrEntry : entryList) {
+      root->addSubEntry(ptrEntry);
+   }
+
+   ++m_hits;
+}
+
+void EntryCache::store(const QString &fileName, const QByteArray &key, QSharedPointer<Entry> root,
+                  int firstChild, const GlobalState &oldState)
+{
+   const QVector<QSharedPointer<Entry>> &children = root->children();
+
+   ++m_misses;
+
+   if (! (globalState() == oldState) || firstChild > children.count()) {
+      ++m_skipped;
+      return;
+   }
+
+   for (int i = firstChild; i < children.count(); ++i) {
+      if (hasEntryState(children[i])) {
+         ++m_skipped;
+         return;
+      }
+   }
+
+   // written to a temporary file first, an interrupted run does not leave a truncated cache file
+   QString cacheName = cacheFileName(fileName);
+   QString tmpName   = cacheName + ".tmp";
+
+   QFile file(tmpName);
+
+   if (! file.open(QIODevice::WriteOnly)) {
+      err("Unable to write parse cache file %s, error: %d\n", csPrintable(tmpName), file.error());
+      return;
+   }
+
+   QDataStream stream(&file);
+
+   stream << s_cacheFormat << key << qint32(children.count() - firstChild);
+
+   for (int i = firstChild; i < children.count(); ++i) {
+      children[i]->writeToStream(stream);
+   }
+
+   file.close();
+
+   QFile::remove(cacheName);
+
+   if (! QFile::rename(tmpName, cacheName)) {
+      err("Unable to write parse cache file %s\n", csPrintable(cacheName));
+   }
+}
+
+EntryCache::GlobalState EntryCache::globalState()
+{
+   GlobalState retval;
+
+   retval.xrefLists        = Doxy_Globals::xrefLists.count();
+   retval.sections         = Doxy_Globals::sectionDict.count();
+   retval.formulas         = Doxy_Globals::formulaList.count();
+   retval.citations        = Doxy_Globals::citeDict.count();
+   retval.memberGroups     = Doxy_Globals::memGrpInfoDict.count();
+   retval.namespaceAliases = Doxy_Globals::namespaceAliasDict.count();
+
+   return retval;
+}
+
+void EntryCache::printStatistics()
+{
+   if (isEnabled()) {
+      msg("Parse cache used %d/%d, %d files were not cacheable\n", m_hits, m_hits + m_misses, m_skipped);
+   }
+}
@@ -0,0 +1,83 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#ifndef ENTRYCACHE_H
+#define ENTRYCACHE_H
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include <parse_base.h>
+#include <types.h>
+
+class Entry;
+
+/** Stores the entries produced by parsing an input file on disk
+ *
+ *  The key is a hash of the input file as read, combined with the language, the parser mode and
+ *  a checksum of the project settings. The headers and macros the preprocessor used are checked
+ *  by replayPreprocessFile(), which also restores the effect of preprocessing the file. On a hit
+ *  the file is not preprocessed, converted or scanned. Files which changed global data while being
+ *  parsed (sections, formulas, citations, member groups, xref lists, namespace aliases) are not
+ *  cached since these changes are not part of the entry tree.
+ */
+class EntryCache
+{
+ public:
+   // snapshot of the global data a scanner can modify
+   struct GlobalState {
+      int xrefLists;
+      int sections;
+      int formulas;
+      int citations;
+      int memberGroups;
+      int namespaceAliases;
+
+      bool operator==(const GlobalState &other) const;
+   };
+
+   static bool isEnabled();
+
+   // buffer is the input file as read, before it is preprocessed
+   static QByteArray cacheKey(const QString &fileName, const QString &buffer, SrcLangExt lang, ParserMode mode);
+
+   // reads the cached entries for fileName, returns false if the cache can not be used
+   static bool load(const QString &fileName, const QByteArray &key, QVector<QSharedPointer<Entry>> &entryList);
+
+   // appends the entries returned by load() to root
+   static void addEntries(QSharedPointer<Entry> root, const QVector<QSharedPointer<Entry>> &entryList);
+
+   // stores the children of root starting at firstChild, unless the global data was modified
+   static void store(const QString &fileName, const QByteArray &key, QSharedPointer<Entry> root,
+                  int firstChild, const GlobalState &oldState);
+
+   static GlobalState globalState();
+
+   static void printStatistics();
+
+ private:
+   static QString cacheFileName(const QString &fileName);
+
+   static int m_hits;
+   static int m_misses;
+   static int m_skipped;
+};
+
+#endif
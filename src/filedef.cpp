@@ -16,6 +16,18 @@
 *
 *************************************************************************/
 
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QProcess>
+#include <QQueue>
+#include <QSet>
+#include <QThread>
+#include <QWaitCondition>
+
 #include <filedef.h>
 
 #include <config.h>
@@ -31,6 +43,7 @@
 #include <outputlist.h>
 #include <parse_base.h>
 #include <parse_clang.h>
+#include <trace.h>
 #include <util.h>
 
 /** Class implementing CodeOutputInterface by throwing away everything. */
@@ -60,6 +73,427 @@ class DevNullCodeDocInterface : public CodeOutputInterface
    void addWord(const QString &, bool) override {}
 };
 
+/** Runs file-version-filter for the input files on worker threads while the input is parsed
+ *
+ *  Results are kept for the rest of the run and stored in <parse-cache-dir>/versions.db, a file
+ *  with the same path and modification time is not passed to the filter again in the next run.
+ */
+class FileVersionReader
+{
+ public:
+   static FileVersionReader &instance() {
+      static FileVersionReader retval;
+      return retval;
+   }
+
+   // starts reading the versions of the files in the list
+   void start(const QStringList &fileList, int numThreads);
+
+   // returns the version of fileName, waits if the version is being read
+   QString version(const QString &fileName);
+
+ private:
+   class Worker : public QThread
+   {
+    public:
+      Worker(FileVersionReader *owner)
+         : m_owner(owner)
+      { }
+
+      void run() override {
+         m_owner->work();
+      }
+
+    private:
+      FileVersionReader *m_owner;
+   };
+
+   struct CacheItem {
+      qint64  lastModified;
+      QString version;
+   };
+
+   FileVersionReader()
+      : m_remaining(0), m_cacheSaved(false)
+   { }
+
+   ~FileVersionReader();
+
+   void work();
+   void finished(const QString &fileName, const QString &version);
+   void loadCache();
+
+   static void saveCache(const QHash<QString, CacheItem> &items);
+
+   static QString runFilter(const QString &fileName);
+   static bool runBatchFilter(const QStringList &fileList, QStringList &versions);
+   static QString cacheFileName();
+
+   QQueue<QString> m_queue;
+   QSet<QString>   m_pending;                // queued or being read
+
+   QHash<QString, QString>   m_versions;
+   QHash<QString, qint64>    m_lastModified;
+   QHash<QString, CacheItem> m_cache;
+
+   QVector<Worker *> m_workers;
+   int  m_remaining;
+   bool m_cacheSaved;
+
+   QMutex         m_mutex;
+   QWaitCondition m_versionReady;
+};
+
+// increment when the layout of the stored versions changes
+static const qint32 s_versionCacheFormat = 1;
+
+// time in milliseconds the batch filter may take to start, and to finish per file
+static const int s_batchFilterStartTimeout = 30000;
+static const int s_batchFilterFileTimeout  = 1000;
+
+FileVersionReader::~FileVersionReader()
+{
+   for (auto worker : m_workers) {
+      worker->wait();
+      delete worker;
+   }
+}
+
+void FileVersionReader::start(const QStringList &fileList, int numThreads)
+{
+   static const bool batchMode = Config::getBool("file-version-batch");
+
+   loadCache();
+
+   QMutexLocker locker(&m_mutex);
+   int cached = 0;
+
+   for (const auto &fileName : fileList) {
+
+      if (m_versions.contains(fileName) || m_pending.contains(fileName)) {
+         continue;
+      }
+
+      qint64 lastModified = QFileInfo(fileName).lastModified().toMSecsSinceEpoch();
+      auto iter = m_cache.constFind(fileName);
+
+      if (iter != m_cache.constEnd() && iter.value().lastModified == lastModified) {
+         m_versions.insert(fileName, iter.value().version);
+         ++cached;
+
+      } else {
+         m_lastModified.insert(fileName, lastModified);
+         m_pending.insert(fileName);
+         m_queue.enqueue(fileName);
+      }
+   }
+
+   m_remaining = m_queue.size();
+
+   msg("Reading file versions, %d of %d files found in the cache\n", cached, cached + m_remaining);
+
+   if (m_queue.isEmpty()) {
+      return;
+   }
+
+   if (batchMode || numThreads < 1) {
+      // a batch is passed to a single filter process
+      numThreads = 1;
+   }
+
+   numThreads = qMin(numThreads, m_queue.size());
+
+   for (int i = 0; i < numThreads; ++i) {
+      Worker *worker = new Worker(this);
+      m_workers.append(worker);
+
+      worker->start();
+   }
+}
+
+QString FileVersionReader::version(const QString &fileName)
+{
+   QMutexLocker locker(&m_mutex);
+
+   while (true) {
+      auto iter = m_versions.constFind(fileName);
+
+      if (iter != m_versions.constEnd()) {
+         return iter.value();
+      }
+
+      if (! m_pending.contains(fileName)) {
+         break;
+      }
+
+      m_versionReady.wait(&m_mutex);
+   }
+
+   // not an input file, run the filter for this file only
+   locker.unlock();
+   QString retval = runFilter(fileName);
+   locker.relock();
+
+   m_versions.insert(fileName, retval);
+
+   return retval;
+}
+
+void FileVersionReader::work()
+{
+   static const bool batchMode = Config::getBool("file-version-batch");
+
+   QMutexLocker locker(&m_mutex);
+
+   if (batchMode && ! m_queue.isEmpty()) {
+      QStringList fileList;
+
+      while (! m_queue.isEmpty()) {
+         fileList.append(m_queue.dequeue());
+      }
+
+      locker.unlock();
+
+      QStringList versions;
+      bool ok = runBatchFilter(fileList, versions);
+
+      locker.relock();
+
+      if (ok) {
+         for (int i = 0; i < fileList.size(); ++i) {
+            finished(fileList[i], versions[i]);
+         }
+
+      } else {
+         warn_uncond("File version filter did not return one line per file, running it once per file\n");
+
+         for (const auto &fileName : fileList) {
+            m_queue.enqueue(fileName);
+         }
+      }
+   }
+
+   while (! m_queue.isEmpty()) {
+      QString fileName = m_queue.dequeue();
+
+      locker.unlock();
+      QString version = runFilter(fileName);
+      locker.relock();
+
+      finished(fileName, version);
+   }
+
+   if (m_remaining == 0 && ! m_cacheSaved) {
+      // only files seen in this run are kept
+      QHash<QString, CacheItem> items;
+
+      for (auto iter = m_cache.constBegin(); iter != m_cache.constEnd(); ++iter) {
+         if (m_versions.contains(iter.key())) {
+            items.insert(iter.key(), iter.value());
+         }
+      }
+
+      m_cacheSaved = true;
+
+      // callers of version() are not blocked while the file is written
+      locker.unlock();
+      saveCache(items);
+   }
+}
+
+// called with the mutex locked
+void FileVersionReader::finished(const QString &fileName, const QString &version)
+{
+   m_versions.insert(fileName, version);
+   m_pending.remove(fileName);
+
+   CacheItem item;
+   item.lastModified = m_lastModified.value(fileName);
+   item.version      = version;
+
+   m_cache.insert(fileName, item);
+
+   --m_remaining;
+
+   m_versionReady.wakeAll();
+}
+
+QString FileVersionReader::runFilter(const QString &fileName)
+{
+   static const QString vercmd = Config::getString("file-version-filter");
+
+   QString cmd = vercmd + " \"" + fileName + "\"";
+   FILE *f = popen(csPrintable(cmd), "r");
+
+   if (! f) {
+      err("Unable to execute %s\n", csPrintable(vercmd));
+      return QString();
+   }
+
+   // get the file version
+   const int bufSize = 1024;
+
+   QByteArray buffer;
+   buffer.resize(bufSize);
+
+   int numRead = fread(buffer.data(), 1, bufSize - 1, f);
+   pclose(f);
+
+   if (numRead > 0 && numRead < bufSize) {
+      buffer.resize(numRead);
+      return QString::fromUtf8(buffer.trimmed());
+   }
+
+   return QString();
+}
+
+bool FileVersionReader::runBatchFilter(const QStringList &fileList, QStringList &versions)
+{
+   static const QString vercmd = Config::getString("file-version-filter");
+
+   // file names are passed on stdin, the filter prints one line per file in the same order
+   QProcess filterProcess;
+   filterProcess.start(vercmd);
+
+   if (! filterProcess.waitForStarted(s_batchFilterStartTimeout)) {
+      filterProcess.kill();
+      filterProcess.waitForFinished();
+
+      return false;
+   }
+
+   for (const auto &fileName : fileList) {
+      filterProcess.write(fileName.toUtf8() + "\n");
+   }
+
+   filterProcess.closeWriteChannel();
+
+   if (! filterProcess.waitForFinished(s_batchFilterStartTimeout + s_batchFilterFileTimeout * fileList.size())) {
+      // filter does not handle a list of files, the caller runs it once per file
+      filterProcess.kill();
+      filterProcess.waitForFinished();
+
+      return false;
+   }
+
+   if (filterProcess.exitStatus() != QProcess::NormalExit || filterProcess.exitCode() != 0) {
+      return false;
+   }
+
+   QList<QByteArray> lines = filterProcess.readAllStandardOutput().split('\n');
+
+   if (! lines.isEmpty() && lines.last().isEmpty()) {
+      // output ends with a newline
+      lines.removeLast();
+   }
+
+   if (lines.size() != fileList.size()) {
+      return false;
+   }
+
+   for (const auto &line : lines) {
+      versions.append(QString::fromUtf8(line.trimmed()));
+   }
+
+   return true;
+}
+
+QString FileVersionReader::cacheFileName()
+{
+   static const QString cacheDir = Config::getString("parse-cache-dir");
+
+   if (cacheDir.isEmpty()) {
+      return QString();
+   }
+
+   return cacheDir + "/versions.db";
+}
+
+void FileVersionReader::loadCache()
+{
+   static const QString vercmd = Config::getString("file-version-filter");
+
+   QString fileName = cacheFileName();
+
+   if (fileName.isEmpty()) {
+      return;
+   }
+
+   QFile file(fileName);
+
+   if (! file.open(QIODevice::ReadOnly)) {
+      return;
+   }
+
+   QDataStream stream(&file);
+
+   qint32 format;
+   qint32 count;
+   QString command;
+
+   stream >> format >> command;
+
+   if (format != s_versionCacheFormat || command != vercmd) {
+      return;
+   }
+
+   QHash<QString, CacheItem> cache;
+
+   stream >> count;
+
+   for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QString name;
+      CacheItem item;
+
+      stream >> name >> item.lastModified >> item.version;
+      cache.insert(name, item);
+   }
+
+   if (stream.status() == QDataStream::Ok) {
+      QMutexLocker locker(&m_mutex);
+      m_cache = cache;
+   }
+}
+
+void FileVersionReader::saveCache(const QHash<QString, CacheItem> &items)
+{
+   static const QString vercmd = Config::getString("file-version-filter");
+
+   QString fileName = cacheFileName();
+
+   if (fileName.isEmpty()) {
+      return;
+   }
+
+   QDir dir;
+   dir.mkpath(QFileInfo(fileName).absolutePath());
+
+   // written to a temporary file first, an interrupted run leaves the old cache intact
+   QString tmpName = fileName + ".tmp";
+   QFile file(tmpName);
+
+   if (! file.open(QIODevice::WriteOnly)) {
+      err("Unable to write file version cache %s, error: %d\n", csPrintable(tmpName), file.error());
+      return;
+   }
+
+   QDataStream stream(&file);
+
+   stream << s_versionCacheFormat << vercmd << qint32(items.size());
+
+   for (auto iter = items.constBegin(); iter != items.constEnd(); ++iter) {
+      stream << iter.key() << iter.value().lastModified << iter.value().version;
+   }
+
+   file.close();
+
+   QFile::remove(fileName);
+
+   if (! QFile::rename(tmpName, fileName)) {
+      err("Unable to write file version cache %s\n", csPrintable(fileName));
+   }
+}
+
 /*! create a new file definition, where \a p is the file path,
     \a nm the file name, and \a lref is an HTML anchor name if the
     file was read from a tag file or 0 otherwise
@@ -91,7 +525,7 @@ FileDef::FileDef(const QString &p, const QString &nm, const QString &lref, const
 
    setLanguage(getLanguageFromFileName(name()));
 
-   acquireFileVersion();
+   m_versionAcquired = false;
    m_subGrouping = Config::getBool("allow-sub-grouping");
 }
 
@@ -609,12 +1043,13 @@ void FileDef::writeSummaryLinks(OutputList &ol)
 void FileDef::writeDocumentation(OutputList &ol)
 {
    QSharedPointer<FileDef> self = sharedFrom(this);
+   Trace::Scope trace("file", getFilePath());
    static const bool generateTreeView = Config::getBool("generate-treeview");
 
    QString versionTitle;
 
-   if (! m_fileVersion.isEmpty()) {
-      versionTitle = ("(" + m_fileVersion + ")");
+   if (! fileVersion().isEmpty()) {
+      versionTitle = ("(" + fileVersion() + ")");
    }
 
    QString title     = m_docname + versionTitle;
@@ -655,7 +1090,7 @@ void FileDef::writeDocumentation(OutputList &ol)
 
    ol.startContents();
 
-   if (! m_fileVersion.isEmpty()) {
+   if (! fileVersion().isEmpty()) {
       ol.disableAllBut(OutputGenerator::Html);
       ol.startProjectNumber();
       ol.docify(versionTitle);
@@ -855,9 +1290,10 @@ void FileDef::writeQuickMemberLinks(OutputList &ol, QSharedPointer<MemberDef> cu
 }
 
 // write source listing of this file to the output
-void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFiles)
+void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFiles, const QString *fileBuffer)
 {
    QSharedPointer<FileDef> self = sharedFrom(this);
+   Trace::Scope trace("source", getFilePath());
 
    static const bool generateTreeView  = Config::getBool("generate-treeview");
    static const bool filterSourceFiles = Config::getBool("filter-source-files");
@@ -868,8 +1304,8 @@ void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFile
    DevNullCodeDocInterface devNullIntf;
    QString title = m_docname;
 
-   if (! m_fileVersion.isEmpty()) {
-      title += (" (" + m_fileVersion + ")");
+   if (! fileVersion().isEmpty()) {
+      title += (" (" + fileVersion() + ")");
    }
 
    QString pageTitle = theTranslator->trSourceFile(title);
@@ -943,7 +1379,7 @@ void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFile
          ClangParser::instance()->switchToFile(getFilePath());
 
       } else {
-         ClangParser::instance()->start(getFilePath(), QString(), includedFiles, QSharedPointer<Entry>());
+         ClangParser::instance()->start(getFilePath(), fileBuffer ? *fileBuffer : QString(), includedFiles, QSharedPointer<Entry>());
 
       }
 
@@ -968,7 +1404,10 @@ void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFile
          pIntf->parseCode(devNullIntf, 0, fileToString(getFilePath(), true, true), getLanguage(), false, 0, self);
       }
 
-      pIntf->parseCode(ol, 0, fileToString(getFilePath(), filterSourceFiles, true),
+      // contents may have been read in advance by the caller
+      QString sourceCode = fileBuffer ? *fileBuffer : fileToString(getFilePath(), filterSourceFiles, true);
+
+      pIntf->parseCode(ol, 0, sourceCode,
                        srcLang, false, 0, self, -1, -1, false,
                        QSharedPointer<MemberDef>(), true, QSharedPointer<Definition>(), ! needs2PassParsing);
 
@@ -980,7 +1419,7 @@ void FileDef::writeSource(OutputList &ol, bool sameTu, QStringList &includedFile
    ol.enableAll();
 }
 
-void FileDef::parseSource(bool sameTu, QStringList &includedFiles)
+void FileDef::parseSource(bool sameTu, QStringList &includedFiles, const QString *fileBuffer)
 {
    QSharedPointer<FileDef> self  = sharedFrom(this);
    static bool filterSourceFiles = Config::getBool("filter-source-files");
@@ -995,7 +1434,7 @@ void FileDef::parseSource(bool sameTu, QStringList &includedFiles)
       if (sameTu) {
          ClangParser::instance()->switchToFile(getFilePath());
       } else {
-         ClangParser::instance()->start(getFilePath(), QString(), includedFiles, QSharedPointer<Entry>());
+         ClangParser::instance()->start(getFilePath(), fileBuffer ? *fileBuffer : QString(), includedFiles, QSharedPointer<Entry>());
       }
 
       ClangParser::instance()->writeSources(devNullIntf, self);
@@ -1005,7 +1444,8 @@ void FileDef::parseSource(bool sameTu, QStringList &includedFiles)
 
       ParserInterface *pIntf = Doxy_Globals::parserManager.getParser(getDefFileExtension());
       pIntf->resetCodeParserState();
-      pIntf->parseCode(devNullIntf, 0, fileToString(getFilePath(), filterSourceFiles, true), srcLang, false, 0, self);
+      QString sourceCode = fileBuffer ? *fileBuffer : fileToString(getFilePath(), filterSourceFiles, true);
+      pIntf->parseCode(devNullIntf, 0, sourceCode, srcLang, false, 0, self);
    }
 }
 
@@ -1515,43 +1955,34 @@ void FileDef::combineUsingRelations()
    }
 }
 
-void FileDef::acquireFileVersion()
+void FileDef::acquireFileVersion() const
 {
    static const QString vercmd = Config::getString("file-version-filter");
 
-   if (! vercmd.isEmpty() && ! m_filePath.isEmpty() && m_filePath != "generated" && m_filePath != "graph_legend") {
+   m_versionAcquired = true;
 
-      msg("Version of %s : ", csPrintable(m_filePath));
-
-      QString cmd = vercmd + " \"" + m_filePath + "\"";
-      FILE *f = popen(csPrintable(cmd), "r");
-
-      if (! f) {
-         err("Unable to execute %s\n", csPrintable(vercmd));
-         return;
-      }
-
-      // get the file version
-      const int bufSize = 1024;
+   if (! vercmd.isEmpty() && ! m_filePath.isEmpty() && m_filePath != "generated" && m_filePath != "graph_legend") {
+      m_fileVersion = FileVersionReader::instance().version(m_filePath);
+   }
+}
 
-      QByteArray buffer;
-      buffer.resize(bufSize);
+void FileDef::startVersionFilter(int numThreads)
+{
+   static const QString vercmd = Config::getString("file-version-filter");
 
-      int numRead = fread(buffer.data(), 1, bufSize - 1, f);
-      pclose(f);
+   if (vercmd.isEmpty()) {
+      return;
+   }
 
-      if (numRead > 0 && numRead < bufSize) {
-         buffer.resize(numRead);
-         m_fileVersion = QString::fromUtf8(buffer.trimmed());
+   QStringList fileList;
 
-         if (! m_fileVersion.isEmpty()) {
-            msg("%s\n", csPrintable(m_fileVersion));
-            return;
-         }
+   for (auto &fn : Doxy_Globals::inputNameList) {
+      for (auto fd : *fn) {
+         fileList.append(fd->getFilePath());
       }
-
-      msg("No file version available\n");
    }
+
+   FileVersionReader::instance().start(fileList, numThreads);
 }
 
 QString FileDef::getSourceFileBase() const
@@ -1684,5 +2115,9 @@ QString FileDef::title() const
 
 QString FileDef::fileVersion() const
 {
+   if (! m_versionAcquired) {
+      acquireFileVersion();
+   }
+
    return m_fileVersion;
 }
@@ -133,7 +133,7 @@ class FileDef : public Definition
 
    /*! Returns version of this file. */
    QString getVersion() const {
-      return m_fileVersion;
+      return fileVersion();
    }
 
    bool isLinkableInProject() const override;
@@ -203,6 +203,9 @@ class FileDef : public Definition
    bool hasDetailedDescription() const;
    QString fileVersion() const;
 
+   // starts reading the versions of the input files in the background
+   static void startVersionFilter(int numThreads);
+
    bool subGrouping() const {
       return m_subGrouping;
    }
@@ -216,8 +219,8 @@ class FileDef : public Definition
    void writeTagFile(QTextStream &t);
 
    void startParsing();
-   void writeSource(OutputList &ol, bool sameTu, QStringList &filesInSameTu);
-   void parseSource(bool sameTu, QStringList &filesInSameTu);
+   void writeSource(OutputList &ol, bool sameTu, QStringList &filesInSameTu, const QString *fileBuffer = nullptr);
+   void parseSource(bool sameTu, QStringList &filesInSameTu, const QString *fileBuffer = nullptr);
    void finishParsing();
 
    friend void generatedFileNames();
@@ -256,7 +259,7 @@ class FileDef : public Definition
    /**
     * Retrieves the file version from version control system.
     */
-   void acquireFileVersion();
+   void acquireFileVersion() const;
 
  private:
    QSharedPointer<MemberList> createMemberList(MemberListType lt);
@@ -298,7 +301,8 @@ class FileDef : public Definition
    QHash<long, QSharedPointer<MemberDef>>  m_srcMemberDict;
 
    bool               m_isSource;
-   QString            m_fileVersion;
+   mutable QString    m_fileVersion;
+   mutable bool       m_versionAcquired;
 
    QSharedPointer<PackageDef> m_package;
 
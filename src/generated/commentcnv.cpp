@@ -1086,6 +1086,7 @@ char *commentcnvYYtext;
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <chunkedbuffer.h>
 #include <config.h>
 #include <condparser.h>
 #include <doxy_globals.h>
@@ -1120,6 +1121,9 @@ struct CommentCtx
 static QString  s_inputString;
 static QString  s_outputString;
 static int      s_inputPosition;
+static bool     s_inputEndsWithNewline;
+
+static ChunkedBuffer *s_inputBuffer = nullptr;
 
 static int      s_col;
 static int      s_blockHeadCol;
@@ -1299,6 +1303,23 @@ static void replaceAliases(const QString &s)
 
 static int yyread(char *buf, int max_size)
 {
+   while (s_inputBuffer != nullptr && s_inputPosition >= s_inputString.size_storage()) {
+      // current chunk is used up, wait for the next one
+      QString chunk;
+
+      if (s_inputBuffer->take(chunk)) {
+         s_inputEndsWithNewline = chunk.endsWith("\n");
+         s_inputString = std::move(chunk);
+
+      } else {
+         // add extra newline to help parser
+         s_inputBuffer = nullptr;
+         s_inputString = s_inputEndsWithNewline ? QString() : QString("\n");
+      }
+
+      s_inputPosition = 0;
+   }
+
    int len = max_size;
 
    const char *src = s_inputString.constData() + s_inputPosition;
@@ -3828,12 +3849,10 @@ static bool recognizeFixedForm(const QString &contents)
  *  3 Handles conditional sections (cond...endcond blocks)
  */
 
-// main entry point
-QString convertCppComments(const QString &inBuf, const QString &fileName)
+static QString convertComments(const QString &fileName)
 {
    s_mlBrief  = Config::getBool("multiline-cpp-brief");
 
-   s_inputString  = inBuf;
    s_outputString       = "";
 
    s_inputPosition = 0;
@@ -3852,7 +3871,22 @@ QString convertCppComments(const QString &inBuf, const QString &fileName)
    isFixedForm = false;
 
    if (s_lang == SrcLangExt_Fortran) {
-      isFixedForm = recognizeFixedForm(inBuf);
+      if (s_inputBuffer != nullptr) {
+         // fixed form detection needs to look ahead, collect the complete input first
+         QString chunk;
+
+         while (s_inputBuffer->take(chunk)) {
+            s_inputString += chunk;
+         }
+
+         s_inputBuffer = nullptr;
+
+         if (! s_inputString.endsWith("\n")) {
+            s_inputString += '\n';
+         }
+      }
+
+      isFixedForm = recognizeFixedForm(s_inputString);
    }
 
    if (s_lang == SrcLangExt_Markdown) {
@@ -3904,5 +3938,26 @@ QString convertCppComments(const QString &inBuf, const QString &fileName)
    s_commentStack.clear();
    s_nestingCount = 0;
 
+   s_inputString = QString();
+
    return s_outputString;
 }
+
+// main entry point
+QString convertCppComments(const QString &inBuf, const QString &fileName)
+{
+   s_inputString = inBuf;
+   s_inputBuffer = nullptr;
+
+   return convertComments(fileName);
+}
+
+// main entry point, reads the input from a buffer which is filled while converting
+QString convertCppComments(ChunkedBuffer &input, const QString &fileName)
+{
+   s_inputString = QString();
+   s_inputBuffer = &input;
+   s_inputEndsWithNewline = false;
+
+   return convertComments(fileName);
+}
@@ -4078,6 +4078,9 @@ static QString addFormula()
    QString formLabel;
    QString fText = formulaText.simplified();
 
+   // the formula id is global, the parse cache can not store this entry
+   current->globalDocs = true;
+
    auto f = Doxy_Globals::formulaDict.find(fText);
 
    if (f == Doxy_Globals::formulaDict.end()) {
@@ -4153,6 +4156,7 @@ static void addCite()
       text = text.mid(1);
    }
 
+   current->globalDocs = true;
    Doxy_Globals::citeDict.insert(text);
 }
 
@@ -2643,6 +2643,10 @@ char *preYYtext;
 #include <ctype.h>
 #include <errno.h>
 
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -2656,14 +2660,17 @@ char *preYYtext;
 
 #include <a_define.h>
 #include <arguments.h>
+#include <chunkedbuffer.h>
 #include <constexp.h>
 #include <config.h>
 #include <condparser.h>
+#include <doxy_build_info.h>
 #include <doxy_globals.h>
 #include <default_args.h>
 #include <entry.h>
 #include <message.h>
 #include <membername.h>
+#include <portable.h>
 #include <util.h>
 
 #define YY_NEVER_INTERACTIVE 1
@@ -2683,6 +2690,8 @@ struct CondCtx
    bool skip;
 };
 
+struct MacroLog;
+
 struct FileState {
    FileState(int size) : lineNr(1), curlyCount(0), fileBuf(size),
       oldFileBuf(""), oldFileBufPos(0), bufState(0) {}
@@ -2695,6 +2704,8 @@ struct FileState {
    int       oldFileBufPos;
    QString   fileName;
    YY_BUFFER_STATE bufState;
+
+   QSharedPointer<MacroLog> macroLog;    // only set while the header is recorded for the macro database
 };
 
 /** @brief Singleton which manages the defines available while proprocessing files
@@ -2735,6 +2746,14 @@ class DefineManager
 
       void collectDefines(DefineDict &dict, QSet<QString> &includeStack);
 
+      const DefineDict &defines() const {
+         return m_defines;
+      }
+
+      const QSet<QString> &includedFiles() const {
+         return m_includedFiles;
+      }
+
     private:
       DefineDict m_defines;
       QSet<QString> m_includedFiles;
@@ -2871,6 +2890,20 @@ class DefineManager
       return m_contextDefines;
    }
 
+   /** Returns the defines and include files added for a file or false if the file is unknown. */
+   bool fileContents(const QString &fileName, const DefineDict *&defines, const QSet<QString> *&includedFiles) const {
+      QSharedPointer<DefinesPerFile> dpf = find(fileName);
+
+      if (dpf == nullptr) {
+         return false;
+      }
+
+      defines       = &dpf->defines();
+      includedFiles = &dpf->includedFiles();
+
+      return true;
+   }
+
  private:
    static DefineManager *theInstance;
 
@@ -2974,6 +3007,7 @@ static int          s_lastCPPContext;
 static QStack<int>  s_levelGuard;
 
 static QString      s_outputString;
+static ChunkedBuffer *s_outputBuffer = nullptr;
 static QString      s_inputString;
 static int          s_inputPosition;
 
@@ -3006,27 +3040,383 @@ static int          s_fenceSize = 0;
 static bool         s_ccomment;
 
 static QSet<QString> s_allIncludes;
+static QString       s_lastIncludeName;   // absolute name of the file last checked by checkAndOpenFile()
+
+/** Header lookup cached for the whole run, valid as long as the size and modification time
+ *  of the file do not change
+ */
+struct IncludeFileInfo {
+   bool      isFile     = false;
+   bool      isExcluded = false;
+   qint64    size       = 0;
+
+   QDateTime lastModified;
+   QString   absName;
+};
+
+static QHash<QString, QSharedPointer<IncludeFileInfo>> s_includeFileCache;
+
+// maximum total size of the cached header contents in bytes
+static const int s_maxIncludeContentSize = 64 * 1024 * 1024;
+
+// decoded contents of headers by absolute name, removed when the file changes
+static QCache<QString, QString> s_includeContentCache(s_maxIncludeContentSize);
+
+// result of findFile() per including directory, include name and include type, empty if not found
+static QHash<QString, QString> s_includeResolveCache;
+
+// names of the entries in each directory probed by findFile()
+static QHash<QString, QSet<QString>> s_dirContents;
+
+/** Single step in the effect a header has on the macro state. A lookup is stored with its
+ *  result so the header is only replayed when every macro it depends on is unchanged.
+ */
+struct MacroEvent {
+   enum Kind { Lookup, GuardCompare, GuardSet, Define, Undef, Include, Member };
+
+   Kind    kind     = Lookup;
+   QString name;                  // macro, guard or include name
+   QString value;                 // lookup result, definition, arguments of a member or resolved include file
+   QString text;                  // include name as written in the #include or initializer of a member
+   QString guard;                 // last guard name when the include was found
+   int     nargs    = -1;
+   int     lineNr   = 0;
+   int     columnNr = 0;
+   bool    flag     = false;      // guard compare result, variable arguments or local include
+   bool    imported = false;
+};
+
+/** Effect of preprocessing a header on the macro state, stored in the macro database
+ *  and replayed the next time the unchanged header is included
+ */
+struct MacroLog {
+   QByteArray contentHash;
+   qint64     size         = 0;
+   qint64     lastModified = 0;
+
+   QString    startLastGuardName;
+   bool       startSkip      = false;
+   bool       endExpectGuard = false;
+   QString    endLastGuardName;
+
+   QVector<MacroEvent> events;
+
+   // only used while recording
+   int        levelGuardSize = 0;
+   int        condStackSize  = 0;
+   bool       replayable     = true;
+
+   // result of each lookup recorded since the macro state last changed, a repeated lookup is not recorded
+   QHash<QString, QString> lookups;
+};
+
+// increment when the layout of the macro database changes
+static const qint32 s_macroDatabaseFormat = 3;
+
+// logs per absolute header name, loaded from and saved to <parse-cache-dir>/macros.db
+static QHash<QString, QSharedPointer<MacroLog>> s_macroDatabase;
+static QSet<QString> s_macroUsed;
+
+// logs per absolute input file name, used by the parse cache to skip preprocessing an unchanged file
+static QHash<QString, QSharedPointer<MacroLog>> s_inputMacroDatabase;
+static QSet<QString> s_inputMacroUsed;
+
+// log of the input file being preprocessed, null if the file is not recorded
+static QSharedPointer<MacroLog> s_inputMacroLog;
+
+static bool         s_macroDatabaseLoaded  = false;
+static bool         s_macroDatabaseChanged = false;
+static int          s_macroReplayed        = 0;
+static int          s_macroProcessed       = 0;
+
+static bool macroDatabaseEnabled()
+{
+   static const bool retval = ! Config::getString("parse-cache-dir").isEmpty();
+   return retval;
+}
+
+// log of the file currently being read, null if the file is not recorded
+static QSharedPointer<MacroLog> currentMacroLog()
+{
+   if (s_includeStack.isEmpty()) {
+      return s_inputMacroLog;
+   }
+
+   return s_includeStack.top()->macroLog;
+}
+
+static QString defineFingerprint(QSharedPointer<A_Define> def)
+{
+   if (def == nullptr) {
+      return QString();
+   }
+
+   QString retval = QString::number(def->nargs);
+
+   retval += def->varArgs      ? "v" : "-";
+   retval += def->nonRecursive ? "n" : "-";
+   retval += def->isPredefined ? "p" : "-";
+   retval += def->m_definition;
+
+   return retval;
+}
+
+/** Macro looked up while the arguments of a function macro were expanded */
+struct MacroLookup {
+   QString name;
+   QSharedPointer<A_Define> def;
+};
+
+// lookups done by the argument expansions in progress, see replaceFunctionMacro()
+static QVector<MacroLookup> s_expansionLookups;
+static int                  s_expansionDepth    = 0;
+static int                  s_expansionMaxLevel = 0;
+
+static void recordLookup(QSharedPointer<MacroLog> log, const QString &name, QSharedPointer<A_Define> def)
+{
+   QString value = defineFingerprint(def);
+   auto iter     = log->lookups.constFind(name);
+
+   if (iter != log->lookups.constEnd() && iter.value() == value) {
+      return;
+   }
+
+   MacroEvent event;
+   event.kind  = MacroEvent::Lookup;
+   event.name  = name;
+   event.value = value;
+
+   log->events.append(event);
+   log->lookups.insert(name, value);
+}
+
+static QSharedPointer<A_Define> lookupDefine(const QString &name)
+{
+   QSharedPointer<A_Define> def = DefineManager::instance().isDefined(name);
+   QSharedPointer<MacroLog> log = currentMacroLog();
+
+   if (s_expansionDepth > 0) {
+      MacroLookup lookup;
+      lookup.name = name;
+      lookup.def  = def;
+
+      s_expansionLookups.append(lookup);
+   }
+
+   if (log) {
+      recordLookup(log, name, def);
+   }
+
+   return def;
+}
+
+// adds the lookups done by a cached macro expansion to the log of the current file
+static void recordLookups(const QVector<MacroLookup> &lookups)
+{
+   QSharedPointer<MacroLog> log = currentMacroLog();
+
+   if (log == nullptr) {
+      return;
+   }
+
+   for (const auto &lookup : lookups) {
+      recordLookup(log, lookup.name, lookup.def);
+   }
+}
+
+static bool isGuardName(const QString &name)
+{
+   bool retval = (s_guardName == name);
+   QSharedPointer<MacroLog> log = currentMacroLog();
+
+   if (log) {
+      MacroEvent event;
+      event.kind = MacroEvent::GuardCompare;
+      event.name = name;
+      event.flag = retval;
+
+      log->events.append(event);
+   }
+
+   return retval;
+}
+
+static void setGuardName(const QString &name)
+{
+   s_guardName = name;
+   QSharedPointer<MacroLog> log = currentMacroLog();
+
+   if (log) {
+      MacroEvent event;
+      event.kind = MacroEvent::GuardSet;
+      event.name = name;
+
+      log->events.append(event);
+   }
+}
+
+static void recordDefine(QSharedPointer<A_Define> def)
+{
+   QSharedPointer<MacroLog> log = currentMacroLog();
+
+   if (log) {
+      MacroEvent event;
+      event.kind     = MacroEvent::Define;
+      event.name     = def->m_name;
+      event.value    = def->m_definition;
+      event.nargs    = def->nargs;
+      event.lineNr   = def->lineNr;
+      event.columnNr = def->columnNr;
+      event.flag     = def->varArgs;
+
+      log->events.append(event);
+      log->lookups.clear();
+   }
+}
+
+static void recordUndef(const QString &name)
+{
+   QSharedPointer<MacroLog> log = currentMacroLog();
+
+   if (log) {
+      MacroEvent event;
+      event.kind = MacroEvent::Undef;
+      event.name = name;
+
+      log->events.append(event);
+      log->lookups.clear();
+   }
+}
+
+static void recordInclude(const QString &absIncFileName, const QString &incFileName, bool localInclude,
+                  const QString &resolvedName)
+{
+   QSharedPointer<MacroLog> log = currentMacroLog();
+
+   if (log) {
+      MacroEvent event;
+      event.kind     = MacroEvent::Include;
+      event.name     = absIncFileName;
+      event.value    = resolvedName;
+      event.text     = incFileName;
+      event.guard    = s_lastGuardName;
+      event.flag     = localInclude;
+      event.imported = s_isImported;
+
+      log->events.append(event);
+      log->lookups.clear();
+
+      if (s_curlyCount > 0) {
+         // a header included inside { ... } is part of the output
+         log->replayable = false;
+      }
+   }
+}
+
+static void recordMember(const QString &name, const QString &args, const QString &initializer, int lineNr, int columnNr)
+{
+   QSharedPointer<MacroLog> log = currentMacroLog();
+
+   if (log) {
+      MacroEvent event;
+      event.kind     = MacroEvent::Member;
+      event.name     = name;
+      event.value    = args;
+      event.text     = initializer;
+      event.lineNr   = lineNr;
+      event.columnNr = columnNr;
+
+      log->events.append(event);
+   }
+}
 static QSet<QString> s_expansionDict;
 
 #define MAX_EXPANSION_DEPTH 50
 
-static void setFileName(const QString &name)
+static QSharedPointer<FileDef> findPreFileDef(const QString &absName)
 {
    bool ambig;
-   QFileInfo fi(name);
-
-   s_yyFileName = fi.absoluteFilePath();
-   s_yyFileDef  = findFileDef(&Doxy_Globals::inputNameDict, s_yyFileName, ambig);
+   QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, absName, ambig);
 
-   if (s_yyFileDef == nullptr) {
+   if (fd == nullptr) {
       // if this is not an input file check if it is an include file
-      s_yyFileDef = findFileDef(&Doxy_Globals::includeNameDict, s_yyFileName, ambig);
+      fd = findFileDef(&Doxy_Globals::includeNameDict, absName, ambig);
    }
 
-   if (s_yyFileDef && s_yyFileDef->isReference()) {
-      s_yyFileDef = QSharedPointer<FileDef>();
+   if (fd && fd->isReference()) {
+      fd = QSharedPointer<FileDef>();
    }
 
+   return fd;
+}
+
+// adds the member for a #define found in fileName, fileDef is the FileDef of fileName or null
+static void addDefineMember(QSharedPointer<FileDef> fileDef, const QString &fileName, int lineNr, int columnNr,
+                  const QString &name, const QString &args, const QString &initializer)
+{
+   QSharedPointer<MemberDef> md = QMakeShared<MemberDef>(fileName, lineNr, columnNr,
+               "#define", name, args, "", Public, Normal, false, Member,
+               MemberType_Define, ArgumentList(), ArgumentList());
+
+   if (! args.isEmpty()) {
+      ArgumentList argList;
+
+      argList = stringToArgumentList(args);
+      md->setArgumentList(argList);
+   }
+
+   md->setInitializer(initializer);
+
+   md->setFileDef(s_inputFileDef);
+   md->setDefinition("#define " + name);
+
+   QSharedPointer<MemberName> mn = Doxy_Globals::functionNameSDict.find(name);
+
+   if (! mn) {
+      mn = QMakeShared<MemberName>(name);
+      Doxy_Globals::functionNameSDict.insert(name, mn);
+   }
+
+   mn->append(md);
+
+   if (fileDef) {
+      fileDef->insertMember(md);
+   }
+}
+
+// adds the dependencies for an #include found in the file of fileDef, openedName is the header
+// which was read for the include or empty if it was not found or already included
+static void addIncludeDependencies(QSharedPointer<FileDef> fileDef, const QString &incFileName,
+                  const QString &absIncFileName, const QString &openedName, bool localInclude, bool imported)
+{
+   if (fileDef) {
+      // add include dependency to the file in which the #include was found
+      bool ambig;
+      QSharedPointer<FileDef> incFd = findFileDef(&Doxy_Globals::inputNameDict, absIncFileName, ambig);
+
+      fileDef->addIncludeDependency(ambig ? QSharedPointer<FileDef>() : incFd, incFileName, localInclude, imported, false);
+
+      if (! openedName.isEmpty()) {
+         incFd = findPreFileDef(openedName);
+      }
+
+      // add included by dependency
+      if (incFd) {
+         incFd->addIncludedByDependency(fileDef, fileDef->docName(), localInclude, imported);
+      }
+
+   } else if (s_inputFileDef) {
+      s_inputFileDef->addIncludeDependency(QSharedPointer<FileDef>(), absIncFileName, localInclude, imported, true);
+   }
+}
+
+static void setFileName(const QString &name)
+{
+   QFileInfo fi(name);
+
+   s_yyFileName = fi.absoluteFilePath();
+   s_yyFileDef  = findPreFileDef(s_yyFileName);
+
    s_insideCS = getLanguageFromFileName(s_yyFileName) == SrcLangExt_CSharp;
    s_isSource = determineSection(s_yyFileName);
 }
@@ -3059,131 +3449,786 @@ static bool otherCaseDone()
    }
 }
 
-static void setCaseDone(bool value)
+static void setCaseDone(bool value)
+{
+   s_levelGuard.top() = value;
+}
+
+static QSharedPointer<IncludeFileInfo> getIncludeFileInfo(const QString &fileName)
+{
+   QFileInfo fi(fileName);
+   bool isFile = fi.exists() && fi.isFile();
+
+   QSharedPointer<IncludeFileInfo> info = s_includeFileCache.value(fileName);
+
+   if (info && info->isFile == isFile) {
+
+      if (! isFile || (info->size == fi.size() && info->lastModified == fi.lastModified())) {
+         return info;
+      }
+   }
+
+   info = QMakeShared<IncludeFileInfo>();
+   info->isFile = isFile;
+
+   if (isFile) {
+      s_includeContentCache.remove(fi.absoluteFilePath());
+
+      static const PatternMatcher exclPatterns(Config::getList("exclude-patterns"));
+
+      info->isExcluded   = exclPatterns.match(fi);
+      info->absName      = fi.absoluteFilePath();
+      info->size         = fi.size();
+      info->lastModified = fi.lastModified();
+   }
+
+   s_includeFileCache.insert(fileName, info);
+
+   return info;
+}
+
+// reads and decodes a header, recently used headers are read only once
+static bool readIncludeFile(QSharedPointer<IncludeFileInfo> info, QString &contents)
+{
+   QString *cached = s_includeContentCache.object(info->absName);
+
+   if (cached != nullptr) {
+      contents = *cached;
+      return true;
+   }
+
+   if (! readInputFile(info->absName, contents)) {
+      return false;
+   }
+
+   s_includeContentCache.insert(info->absName, new QString(contents), contents.size_storage());
+
+   return true;
+}
+
+static QSharedPointer<FileState> checkAndOpenFile(const QString &fileName, bool &alreadyIncluded)
+{
+   alreadyIncluded = false;
+   QSharedPointer<FileState> fs;
+
+   QSharedPointer<IncludeFileInfo> info = getIncludeFileInfo(fileName);
+
+   if (info->isFile) {
+
+      if (info->isExcluded) {
+         return QSharedPointer<FileState>();
+      }
+
+      QString absName   = info->absName;
+      s_lastIncludeName = absName;
+
+      // global guard
+      if (s_curlyCount == 0) {
+         // not #include inside { ... }
+
+         if (s_allIncludes.contains(absName)) {
+            alreadyIncluded = true;
+            return QSharedPointer<FileState>();
+         }
+
+         s_allIncludes.insert(absName);
+      }
+
+      // check include stack for absName
+      QStack<QSharedPointer<FileState>> tmpStack;
+
+      while (! s_includeStack.isEmpty()) {
+         fs = s_includeStack.pop();
+
+         if (fs->fileName == absName) {
+            alreadyIncluded = true;
+         }
+
+         tmpStack.push(fs);
+      }
+
+      while (! tmpStack.isEmpty()) {
+         fs = tmpStack.pop();
+
+         s_includeStack.push(fs);
+      }
+
+      if (alreadyIncluded) {
+         return QSharedPointer<FileState>();
+      }
+
+      fs = QMakeShared<FileState>(info->size + 4096);
+      alreadyIncluded = false;
+
+      if (! readIncludeFile(info, fs->fileBuf)) {
+         // error
+         fs = QSharedPointer<FileState>();
+
+      } else {
+         fs->oldFileBuf    = s_inputString;
+         fs->oldFileBufPos = s_inputPosition;
+      }
+   }
+
+   return fs;
+}
+
+// returns false if the directory of absName has no entry with this name, avoids a stat for each include path
+static bool candidateMayExist(const QString &absName)
+{
+   static const bool caseSensitive = portable_fileSystemIsCaseSensitive() == Qt::CaseSensitive;
+
+   if (! caseSensitive) {
+      // a listing can not be compared with the spelling used in the #include
+      return true;
+   }
+
+   int sepPos = absName.lastIndexOf('/');
+
+   if (sepPos == -1) {
+      return true;
+   }
+
+   QString dirName = absName.left(sepPos);
+   auto iter = s_dirContents.find(dirName);
+
+   if (iter == s_dirContents.end()) {
+      QSet<QString> entries;
+      QDir dir(dirName);
+
+      if (dir.exists()) {
+         for (auto &item : dir.entryList(QDir::Files | QDir::Dirs | QDir::Hidden | QDir::System)) {
+            entries.insert(item);
+         }
+      }
+
+      iter = s_dirContents.insert(dirName, entries);
+   }
+
+   return iter.value().contains(absName.mid(sepPos + 1));
+}
+
+static QSharedPointer<FileState> openResolvedFile(const QString &absName, bool &alreadyIncluded)
+{
+   QSharedPointer<FileState> fs = checkAndOpenFile(absName, alreadyIncluded);
+
+   if (fs) {
+      setFileName(absName);
+      s_yyLineNr = 1;
+   }
+
+   return fs;
+}
+
+// returns the absolute name of the file an #include in includingFile refers to, empty if it is not found
+static QString resolveInclude(const QString &includingFile, const QString &fileName, bool localInclude)
+{
+   QString localDir;
+
+   if (localInclude && ! includingFile.isEmpty()) {
+      QFileInfo fi(includingFile);
+
+      if (fi.exists()) {
+         localDir = fi.absolutePath();
+      }
+   }
+
+   // the same include from the same directory resolves to the same file
+   const QString key = localDir + (localInclude ? "\n\"" : "\n<") + fileName;
+   auto iter = s_includeResolveCache.constFind(key);
+
+   if (iter != s_includeResolveCache.constEnd()) {
+
+      if (iter.value().isEmpty()) {
+         // not found before
+         return QString();
+      }
+
+      QSharedPointer<IncludeFileInfo> info = getIncludeFileInfo(iter.value());
+
+      if (info->isFile && ! info->isExcluded) {
+         return info->absName;
+      }
+
+      // file was removed, search again
+   }
+
+   QStringList candidates;
+
+   if (QDir::isAbsolutePath(fileName)) {
+      candidates.append(fileName);
+   }
+
+   if (! localDir.isEmpty()) {
+      candidates.append(localDir + "/" + fileName);
+   }
+
+   for (auto &s : s_pathList) {
+      candidates.append(s + "/" + fileName);
+   }
+
+   for (auto &absName : candidates) {
+
+      if (! candidateMayExist(absName)) {
+         continue;
+      }
+
+      QSharedPointer<IncludeFileInfo> info = getIncludeFileInfo(absName);
+
+      if (info->isFile && ! info->isExcluded) {
+         s_includeResolveCache.insert(key, absName);
+         return info->absName;
+      }
+   }
+
+   s_includeResolveCache.insert(key, QString());
+
+   return QString();
+}
+
+static QSharedPointer<FileState> findFile(const QString &fileName, bool localInclude, bool &alreadyIncluded)
+{
+   alreadyIncluded = false;
+   QString absName = resolveInclude(s_yyFileName, fileName, localInclude);
+
+   if (absName.isEmpty()) {
+      return QSharedPointer<FileState>();
+   }
+
+   return openResolvedFile(absName, alreadyIncluded);
+}
+
+static void startMacroLog(QSharedPointer<FileState> fs)
+{
+   // headers included inside { ... } are part of the output and are always preprocessed
+   if (! macroDatabaseEnabled() || fs->curlyCount > 0) {
+      return;
+   }
+
+   QSharedPointer<IncludeFileInfo> info = getIncludeFileInfo(s_yyFileName);
+   QSharedPointer<MacroLog> log = QMakeShared<MacroLog>();
+
+   log->contentHash        = QCryptographicHash::hash(fs->fileBuf.toUtf8(), QCryptographicHash::Sha1);
+   log->size               = info->size;
+   log->lastModified       = info->lastModified.toMSecsSinceEpoch();
+   log->startLastGuardName = s_lastGuardName;
+   log->startSkip          = s_skip;
+   log->levelGuardSize     = s_levelGuard.size();
+   log->condStackSize      = s_condStack.size();
+
+   fs->macroLog = log;
+   ++s_macroProcessed;
+}
+
+static void finishMacroLog(QSharedPointer<FileState> fs)
+{
+   QSharedPointer<MacroLog> log = fs->macroLog;
+
+   if (log == nullptr) {
+      return;
+   }
+
+   // a header which leaves an #if or \cond open changes the state of the including file
+   if (! log->replayable || s_levelGuard.size() != log->levelGuardSize || s_condStack.size() != log->condStackSize || s_skip != log->startSkip) {
+      return;
+   }
+
+   log->endExpectGuard   = s_expectGuard;
+   log->endLastGuardName = s_lastGuardName;
+
+   s_macroDatabase.insert(s_yyFileName, log);
+   s_macroUsed.insert(s_yyFileName);
+   s_macroDatabaseChanged = true;
+}
+
+// returns the log for fileName if the header did not change since it was recorded
+static QSharedPointer<MacroLog> findMacroLog(const QString &fileName, const QString *contents)
+{
+   QSharedPointer<MacroLog> log = s_macroDatabase.value(fileName);
+
+   if (log == nullptr) {
+      return log;
+   }
+
+   QSharedPointer<IncludeFileInfo> info = getIncludeFileInfo(fileName);
+
+   if (! info->isFile || info->isExcluded) {
+      return QSharedPointer<MacroLog>();
+   }
+
+   if (info->size == log->size && info->lastModified.toMSecsSinceEpoch() == log->lastModified) {
+      return log;
+   }
+
+   QString fileContents;
+
+   if (contents == nullptr) {
+      if (! readIncludeFile(info, fileContents)) {
+         return QSharedPointer<MacroLog>();
+      }
+
+      contents = &fileContents;
+   }
+
+   if (QCryptographicHash::hash(contents->toUtf8(), QCryptographicHash::Sha1) != log->contentHash) {
+      return QSharedPointer<MacroLog>();
+   }
+
+   // only the time stamp changed
+   log->size         = info->size;
+   log->lastModified = info->lastModified.toMSecsSinceEpoch();
+
+   s_macroDatabaseChanged = true;
+
+   return log;
+}
+
+struct MacroReplayFile {
+   DefineDict    defines;
+   QSet<QString> includedFiles;
+};
+
+/** Macro state as it will be after replaying a header, the DefineManager is only changed
+ *  once the logs of the header and all headers it includes are known to be valid
+ */
+struct MacroReplayState {
+   DefineDict       context;         // defines added to the context by the replayed headers
+   QSet<A_Define *> undefined;       // defines removed by an #undef in the replayed headers
+   QSet<QString>    included;        // headers replayed
+   QSet<QString>    includeStack;    // files currently being read
+   QString          guardName;
+
+   QHash<QString, QSharedPointer<MacroReplayFile>> files;
+};
+
+static bool replayFileContents(const MacroReplayState &state, const QString &fileName,
+                  const DefineDict *&defines, const QSet<QString> *&includedFiles)
+{
+   QSharedPointer<MacroReplayFile> file = state.files.value(fileName);
+
+   if (file) {
+      defines       = &file->defines;
+      includedFiles = &file->includedFiles;
+
+      return true;
+   }
+
+   return DefineManager::instance().fileContents(fileName, defines, includedFiles);
+}
+
+static QSharedPointer<MacroReplayFile> changeReplayFile(MacroReplayState &state, const QString &fileName)
+{
+   QSharedPointer<MacroReplayFile> file = state.files.value(fileName);
+
+   if (file == nullptr) {
+      file = QMakeShared<MacroReplayFile>();
+
+      const DefineDict *defines;
+      const QSet<QString> *includedFiles;
+
+      if (DefineManager::instance().fileContents(fileName, defines, includedFiles)) {
+         file->defines       = *defines;
+         file->includedFiles = *includedFiles;
+      }
+
+      state.files.insert(fileName, file);
+   }
+
+   return file;
+}
+
+// same as DefinesPerFile::collectDefines()
+static void collectReplayDefines(MacroReplayState &state, const DefineDict &defines,
+                  const QSet<QString> &includedFiles, QSet<QString> &includeStack)
+{
+   for (const auto &incFile : includedFiles) {
+      const DefineDict *incDefines;
+      const QSet<QString> *incIncludedFiles;
+
+      if (! includeStack.contains(incFile) && replayFileContents(state, incFile, incDefines, incIncludedFiles)) {
+         includeStack.insert(incFile);
+         collectReplayDefines(state, *incDefines, *incIncludedFiles, includeStack);
+      }
+   }
+
+   for (const auto &def : defines) {
+      state.context.insert(def->m_name, def);
+   }
+}
+
+// same as DefineManager::isDefined()
+static QSharedPointer<A_Define> replayIsDefined(const MacroReplayState &state, const QString &name)
+{
+   QSharedPointer<A_Define> def = state.context.value(name);
+
+   if (def == nullptr) {
+      def = DefineManager::instance().defineContext().value(name);
+   }
+
+   if (def && (def->undef || state.undefined.contains(def.data()))) {
+      def = QSharedPointer<A_Define>();
+   }
+
+   return def;
+}
+
+static QSharedPointer<A_Define> replayDefine(const QString &fileName, const MacroEvent &event)
+{
+   QSharedPointer<A_Define> def = QMakeShared<A_Define>();
+
+   def->m_name       = event.name;
+   def->m_definition = event.value;
+   def->nargs        = event.nargs;
+   def->m_fileName   = fileName;
+   def->lineNr       = event.lineNr;
+   def->columnNr     = event.columnNr;
+   def->varArgs      = event.flag;
+
+   if (! def->m_name.isEmpty() && Doxy_Globals::expandAsDefinedDict.contains(def->m_name)) {
+      def->isPredefined = true;
+   }
+
+   return def;
+}
+
+static bool checkMacroLog(MacroReplayState &state, const QString &fileName, QSharedPointer<MacroLog> log)
+{
+   if (log->startSkip != s_skip) {
+      return false;
+   }
+
+   for (const auto &event : log->events) {
+
+      switch (event.kind) {
+         case MacroEvent::Lookup:
+            if (defineFingerprint(replayIsDefined(state, event.name)) != event.value) {
+               return false;
+            }
+            break;
+
+         case MacroEvent::GuardCompare:
+            if ((state.guardName == event.name) != event.flag) {
+               return false;
+            }
+            break;
+
+         case MacroEvent::GuardSet:
+            state.guardName = event.name;
+            break;
+
+         case MacroEvent::Define: {
+            QSharedPointer<A_Define> def = replayDefine(fileName, event);
+
+            state.context.insert(def->m_name, def);
+            changeReplayFile(state, fileName)->defines.insert(def->m_name, def);
+            break;
+         }
+
+         case MacroEvent::Undef: {
+            QSharedPointer<A_Define> def = replayIsDefined(state, event.name);
+
+            if (def && ! def->nonRecursive) {
+               state.undefined.insert(def.data());
+            }
+            break;
+         }
+
+         case MacroEvent::Include: {
+            const DefineDict *defines;
+            const QSet<QString> *includedFiles;
+
+            // a header added to the include path since the log was recorded may shadow the recorded one
+            if (resolveInclude(fileName, event.text, event.flag) != event.value) {
+               return false;
+            }
+
+            changeReplayFile(state, fileName)->includedFiles.insert(event.name);
+
+            if (replayFileContents(state, event.name, defines, includedFiles)) {
+               QSet<QString> includeStack;
+               collectReplayDefines(state, *defines, *includedFiles, includeStack);
+
+            } else {
+               changeReplayFile(state, event.name);
+            }
+
+            const QString &incName = event.value;
+
+            if (! incName.isEmpty() && ! s_allIncludes.contains(incName) && ! state.included.contains(incName) &&
+                  ! state.includeStack.contains(incName)) {
+
+               state.included.insert(incName);
+
+               QSharedPointer<MacroLog> incLog = findMacroLog(incName, nullptr);
+
+               if (incLog == nullptr || incLog->startLastGuardName != event.guard) {
+                  return false;
+               }
+
+               if (! checkMacroLog(state, incName, incLog)) {
+                  return false;
+               }
+            }
+
+            break;
+         }
+
+         case MacroEvent::Member:
+            break;
+      }
+   }
+
+   return true;
+}
+
+static void applyMacroLog(const MacroReplayState &state, const QString &fileName, QSharedPointer<MacroLog> log)
+{
+   for (const auto &event : log->events) {
+
+      switch (event.kind) {
+         case MacroEvent::Lookup:
+         case MacroEvent::GuardCompare:
+            break;
+
+         case MacroEvent::GuardSet:
+            s_guardName = event.name;
+            break;
+
+         case MacroEvent::Define:
+            DefineManager::instance().addDefine(fileName, replayDefine(fileName, event));
+            break;
+
+         case MacroEvent::Undef: {
+            QSharedPointer<A_Define> def = DefineManager::instance().isDefined(event.name);
+
+            if (def && ! def->nonRecursive) {
+               def->undef = true;
+            }
+            break;
+         }
+
+         case MacroEvent::Include: {
+            DefineManager::instance().addInclude(fileName, event.name);
+            DefineManager::instance().addFileToContext(event.name);
+
+            const QString &incName = event.value;
+            bool opened = false;
+
+            if (! incName.isEmpty() && ! s_allIncludes.contains(incName)) {
+               s_allIncludes.insert(incName);
+               opened = ! state.includeStack.contains(incName);
+            }
+
+            addIncludeDependencies(findPreFileDef(fileName), event.text, event.name, opened ? incName : QString(),
+                  event.flag, event.imported);
+
+            if (opened) {
+               s_macroUsed.insert(incName);
+               applyMacroLog(state, incName, s_macroDatabase.value(incName));
+            }
+
+            break;
+         }
+
+         case MacroEvent::Member:
+            if (Doxy_Globals::gatherDefines) {
+               addDefineMember(findPreFileDef(fileName), fileName, event.lineNr, event.columnNr,
+                     event.name, event.value, event.text);
+            }
+            break;
+      }
+   }
+
+   s_expectGuard   = log->endExpectGuard;
+   s_lastGuardName = log->endLastGuardName;
+}
+
+/** Restores the effect of the header which was just opened from the macro database,
+ *  returns false if the header has to be preprocessed
+ */
+static bool replayIncludeFile(const QString &includingFileName, const QString &contents)
+{
+   if (! macroDatabaseEnabled() || s_curlyCount > 0) {
+      return false;
+   }
+
+   QSharedPointer<MacroLog> log = findMacroLog(s_yyFileName, &contents);
+
+   if (log == nullptr || log->startLastGuardName != s_lastGuardName) {
+      return false;
+   }
+
+   MacroReplayState state;
+   state.guardName = s_guardName;
+   state.includeStack.insert(includingFileName);
+
+   for (const auto &item : s_includeStack) {
+      state.includeStack.insert(item->fileName);
+   }
+
+   if (! checkMacroLog(state, s_yyFileName, log)) {
+      return false;
+   }
+
+   applyMacroLog(state, s_yyFileName, log);
+   s_macroUsed.insert(s_yyFileName);
+
+   ++s_macroReplayed;
+
+   return true;
+}
+
+static QByteArray macroDatabaseKey()
+{
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+
+   hash.addData(Config::getCacheChecksum());
+   hash.addData(versionString.toUtf8());
+
+   return hash.result();
+}
+
+static QSharedPointer<MacroLog> readMacroLog(QDataStream &stream, QString &fileName)
+{
+   qint32 eventCount;
+   QSharedPointer<MacroLog> log = QMakeShared<MacroLog>();
+
+   stream >> fileName >> log->contentHash >> log->size >> log->lastModified >> log->startLastGuardName
+          >> log->startSkip >> log->endExpectGuard >> log->endLastGuardName >> eventCount;
+
+   for (int j = 0; j < eventCount && stream.status() == QDataStream::Ok; ++j) {
+      MacroEvent event;
+      qint32 kind;
+
+      stream >> kind >> event.name >> event.value >> event.text >> event.guard >> event.nargs >> event.lineNr
+             >> event.columnNr >> event.flag >> event.imported;
+
+      event.kind = MacroEvent::Kind(kind);
+      log->events.append(event);
+   }
+
+   if (stream.status() != QDataStream::Ok) {
+      return QSharedPointer<MacroLog>();
+   }
+
+   return log;
+}
+
+static void writeMacroLog(QDataStream &stream, const QString &fileName, QSharedPointer<MacroLog> log)
 {
-   s_levelGuard.top() = value;
+   stream << fileName << log->contentHash << log->size << log->lastModified << log->startLastGuardName
+          << log->startSkip << log->endExpectGuard << log->endLastGuardName << qint32(log->events.size());
+
+   for (const auto &event : log->events) {
+      stream << qint32(event.kind) << event.name << event.value << event.text << event.guard << event.nargs << event.lineNr
+             << event.columnNr << event.flag << event.imported;
+   }
 }
 
-static QSharedPointer<FileState> checkAndOpenFile(const QString &fileName, bool &alreadyIncluded)
+static void loadMacroDatabase()
 {
-   alreadyIncluded = false;
-   QSharedPointer<FileState> fs;
+   s_macroDatabaseLoaded = true;
 
-   QFileInfo fi(fileName);
-
-   if (fi.exists() && fi.isFile()) {
-      static const QStringList exclPatterns = Config::getList("exclude-patterns");
+   QFile file(Config::getString("parse-cache-dir") + "/macros.db");
 
-      if (patternMatch(fi, exclPatterns)) {
-         return QSharedPointer<FileState>();
-      }
+   if (! file.open(QIODevice::ReadOnly)) {
+      return;
+   }
 
-      QString absName = fi.absoluteFilePath();
+   QDataStream stream(&file);
 
-      // global guard
-      if (s_curlyCount == 0) {
-         // not #include inside { ... }
+   qint32 format;
+   qint32 count;
+   QByteArray storedKey;
 
-         if (s_allIncludes.contains(absName)) {
-            alreadyIncluded = true;
-            return QSharedPointer<FileState>();
-         }
+   stream >> format >> storedKey;
 
-         s_allIncludes.insert(absName);
-      }
+   if (format != s_macroDatabaseFormat || storedKey != macroDatabaseKey()) {
+      return;
+   }
 
-      // check include stack for absName
-      QStack<QSharedPointer<FileState>> tmpStack;
+   // logs are read into temporary hashes so a damaged file is ignored as a whole
+   QHash<QString, QSharedPointer<MacroLog>> database;
+   QHash<QString, QSharedPointer<MacroLog>> inputDatabase;
 
-      while (! s_includeStack.isEmpty()) {
-         fs = s_includeStack.pop();
+   stream >> count;
 
-         if (fs->fileName == absName) {
-            alreadyIncluded = true;
-         }
+   for (int i = 0; i < count; ++i) {
+      QString fileName;
+      QSharedPointer<MacroLog> log = readMacroLog(stream, fileName);
 
-         tmpStack.push(fs);
+      if (log == nullptr) {
+         return;
       }
 
-      while (! tmpStack.isEmpty()) {
-         fs = tmpStack.pop();
+      database.insert(fileName, log);
+   }
 
-         s_includeStack.push(fs);
-      }
+   stream >> count;
 
-      if (alreadyIncluded) {
-         return QSharedPointer<FileState>();
-      }
+   for (int i = 0; i < count; ++i) {
+      QString fileName;
+      QSharedPointer<MacroLog> log = readMacroLog(stream, fileName);
 
-      fs = QMakeShared<FileState>(fi.size() + 4096);
-      alreadyIncluded = false;
+      if (log == nullptr) {
+         return;
+      }
 
-      if (! readInputFile(absName, fs->fileBuf)) {
-         // error
-         fs = QSharedPointer<FileState>();
+      inputDatabase.insert(fileName, log);
+   }
 
-      } else {
-         fs->oldFileBuf    = s_inputString;
-         fs->oldFileBufPos = s_inputPosition;
-      }
+   if (stream.status() != QDataStream::Ok) {
+      return;
    }
 
-   return fs;
+   s_macroDatabase      = database;
+   s_inputMacroDatabase = inputDatabase;
 }
 
-static QSharedPointer<FileState> findFile(const QString &fileName, bool localInclude, bool &alreadyIncluded)
+static void saveMacroDatabase()
 {
-   if (QDir::isAbsolutePath(fileName)) {
-      QSharedPointer<FileState> fs = checkAndOpenFile(fileName, alreadyIncluded);
+   static const QString cacheDir = Config::getString("parse-cache-dir");
 
-      if (fs) {
-         setFileName(fileName);
-         s_yyLineNr = 1;
-         return fs;
+   QDir dir;
 
-      } else if (alreadyIncluded) {
-         return QSharedPointer<FileState>();
-      }
+   if (! dir.mkpath(cacheDir)) {
+      err("Unable to create parse cache directory %s\n", csPrintable(cacheDir));
+      return;
    }
 
-   if (localInclude && ! s_yyFileName.isEmpty()) {
-      QFileInfo fi(s_yyFileName);
+   // written to a temporary file first, an interrupted run leaves the old database intact
+   QString fileName = cacheDir + "/macros.db";
+   QString tmpName  = fileName + ".tmp";
 
-      if (fi.exists()) {
-         QString absName = fi.absolutePath() + "/" + fileName;
-         QSharedPointer<FileState> fs = checkAndOpenFile(absName, alreadyIncluded);
-
-         if (fs) {
-            setFileName(absName);
-            s_yyLineNr = 1;
-            return fs;
+   QFile file(tmpName);
 
-         } else if (alreadyIncluded) {
-            return QSharedPointer<FileState>();
-         }
-      }
+   if (! file.open(QIODevice::WriteOnly)) {
+      err("Unable to write macro database %s, error: %d\n", csPrintable(tmpName), file.error());
+      return;
    }
 
-   if (s_pathList.isEmpty()) {
-      return QSharedPointer<FileState>();
-   }
+   QDataStream stream(&file);
 
-   for (auto &s : s_pathList) {
-      QString absName = s + "/" + fileName;
+   // files which were not read in this run are dropped
+   stream << s_macroDatabaseFormat << macroDatabaseKey() << qint32(s_macroUsed.size());
 
-      QSharedPointer<FileState> fs = checkAndOpenFile(absName, alreadyIncluded);
+   for (const auto &item : s_macroUsed) {
+      writeMacroLog(stream, item, s_macroDatabase.value(item));
+   }
 
-      if (fs) {
-         setFileName(absName);
-         s_yyLineNr = 1;
-         return fs;
+   stream << qint32(s_inputMacroUsed.size());
 
-      } else if (alreadyIncluded) {
-         return QSharedPointer<FileState>();
-      }
+   for (const auto &item : s_inputMacroUsed) {
+      writeMacroLog(stream, item, s_inputMacroDatabase.value(item));
    }
 
-   return QSharedPointer<FileState>();
+   file.close();
+
+   QFile::remove(fileName);
+
+   if (! QFile::rename(tmpName, fileName)) {
+      err("Unable to write macro database %s\n", csPrintable(fileName));
+   }
 }
 
 static QString extractTrailingComment(const QString &s)
@@ -3374,6 +4419,61 @@ static inline void addTillEndOfString(const QString &expr, QString *rest, uint &
    }
 }
 
+/** Result of substituting the arguments of a function macro, valid as long as every macro
+ *  looked up while expanding the arguments still resolves to the same definition
+ */
+struct MacroExpansion {
+   QSharedPointer<const A_Define> def;
+   QString result;
+   int     maxLevel;
+
+   QVector<MacroLookup> lookups;
+};
+
+// maximum total size of the cached expansions in characters
+static const int s_maxExpansionCacheSize = 8 * 1024 * 1024;
+
+static QCache<QString, MacroExpansion> s_expansionCache(s_maxExpansionCacheSize);
+static int s_expansionHits   = 0;
+static int s_expansionMisses = 0;
+
+static QString expansionCacheKey(QSharedPointer<const A_Define> def, const QHash<QString, QString> &argTable,
+                  int argCount, int level)
+{
+   // macros currently being expanded are not looked up again
+   QStringList expandedNames = s_expandedDict->keys();
+   expandedNames.sort();
+
+   QString key = QString::number(reinterpret_cast<quintptr>(def.data()), 16);
+
+   key += s_nospaces ? " n " : " - ";
+   key += QString::number(level);
+
+   for (const auto &name : expandedNames) {
+      key += " " + name;
+   }
+
+   key += "\n";
+
+   for (int i = 0; i < argCount; ++i) {
+      const QString arg = argTable.value(QString("@%1").formatArg(i));
+      key += QString::number(arg.length()) + ":" + arg;
+   }
+
+   return key;
+}
+
+static bool isExpansionValid(const MacroExpansion &expansion)
+{
+   for (const auto &lookup : expansion.lookups) {
+      if (DefineManager::instance().isDefined(lookup.name) != lookup.def) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
 /*! replaces the function macro def whose argument list starts at pos in expression \a expr.
  * Notice that this routine may scan beyond the expr string if needed.
  * In that case the characters will be read from the input file.
@@ -3559,6 +4659,35 @@ static bool replaceFunctionMacro(const QString &expr, QString *rest, int pos, in
          // variadic macro with at least as many
          // params as the non-variadic part (see bug731985)
 
+      QString cacheKey = expansionCacheKey(def, argTable, argCount, level);
+      MacroExpansion *expansion = s_expansionCache.object(cacheKey);
+
+      if (expansion != nullptr && expansion->def == def && isExpansionValid(*expansion)) {
+         ++s_expansionHits;
+
+         if (s_expansionDepth > 0) {
+            s_expansionLookups += expansion->lookups;
+         }
+
+         // a recorded file depends on the macros the expansion looked up
+         recordLookups(expansion->lookups);
+
+         s_expansionMaxLevel = qMax(s_expansionMaxLevel, expansion->maxLevel);
+
+         len    = j - pos;
+         result = expansion->result;
+
+         return true;
+      }
+
+      ++s_expansionMisses;
+
+      int lookupStart = s_expansionLookups.size();
+      int oldMaxLevel = s_expansionMaxLevel;
+
+      s_expansionMaxLevel = level;
+      ++s_expansionDepth;
+
       uint k = 0;
 
       // substitution of all formal arguments
@@ -3667,6 +4796,26 @@ static bool replaceFunctionMacro(const QString &expr, QString *rest, int pos, in
          }
       }
 
+      --s_expansionDepth;
+
+      // an expansion which reached the recursion limit depends on the expansions done before
+      if (s_expansionMaxLevel <= MAX_EXPANSION_DEPTH) {
+         expansion = new MacroExpansion;
+
+         expansion->def      = def;
+         expansion->result   = resExpr;
+         expansion->maxLevel = s_expansionMaxLevel;
+         expansion->lookups  = s_expansionLookups.mid(lookupStart);
+
+         s_expansionCache.insert(cacheKey, expansion, cacheKey.length() + resExpr.length() + expansion->lookups.size());
+      }
+
+      if (s_expansionDepth == 0) {
+         s_expansionLookups.clear();
+      }
+
+      s_expansionMaxLevel = qMax(oldMaxLevel, s_expansionMaxLevel);
+
       len    = j - pos;
       result = resExpr;
 
@@ -3759,6 +4908,8 @@ static bool expandExpression(QString &expr, QString *rest, int pos, int level)
      return true;
    }
 
+   s_expansionMaxLevel = qMax(s_expansionMaxLevel, level);
+
    if (s_expansionDict.contains(expr) && level > MAX_EXPANSION_DEPTH) {
       // check for too deep recursive expansions
       return false;
@@ -3791,7 +4942,7 @@ static bool expandExpression(QString &expr, QString *rest, int pos, int level)
          if (! s_expandedDict->contains(macroName)) {
 
             // expand macro
-            QSharedPointer<A_Define> def = DefineManager::instance().isDefined(macroName);
+            QSharedPointer<A_Define> def = lookupDefine(macroName);
 
             if (macroName == "defined") {
                definedTest = true;
@@ -4279,17 +5430,6 @@ void addDefine()
       return;
    }
 
-   QSharedPointer<MemberDef> md = QMakeShared<MemberDef>(s_yyFileName, s_yyLineNr - s_yyMLines, s_yyColNr,
-               "#define", s_defName, s_defArgsStr, "", Public, Normal, false, Member,
-               MemberType_Define, ArgumentList(), ArgumentList());
-
-   if (! s_defArgsStr.isEmpty()) {
-      ArgumentList argList;
-
-      argList = stringToArgumentList(s_defArgsStr);
-      md->setArgumentList(argList);
-   }
-
    int len = s_defLitText.indexOf('\n');
 
    if (len > 0 && s_defLitText.left(len).trimmed() == "\\") {
@@ -4319,23 +5459,11 @@ void addDefine()
 
       s_defLitText = s_defLitText.mid(len + 1, k - len - 1) + s_defLitText.trimmed();
    }
-   md->setInitializer(s_defLitText.trimmed());
 
-   md->setFileDef(s_inputFileDef);
-   md->setDefinition("#define " + s_defName);
-
-   QSharedPointer<MemberName> mn = Doxy_Globals::functionNameSDict.find(s_defName);
-
-   if (! mn) {
-      mn = QMakeShared<MemberName>(s_defName);
-      Doxy_Globals::functionNameSDict.insert(s_defName, mn);
-   }
-
-   mn->append(md);
+   recordMember(s_defName, s_defArgsStr, s_defLitText.trimmed(), s_yyLineNr - s_yyMLines, s_yyColNr);
 
-   if (s_yyFileDef) {
-      s_yyFileDef->insertMember(md);
-   }
+   addDefineMember(s_yyFileDef, s_yyFileName, s_yyLineNr - s_yyMLines, s_yyColNr,
+         s_defName, s_defArgsStr, s_defLitText.trimmed());
 }
 
 static inline void outputChar(QChar c)
@@ -4431,33 +5559,22 @@ static void readIncludeFile(const QString &inc)
       QSharedPointer<FileState> fs;
       bool alreadyIncluded = false;
 
-      if ((fs = findFile(incFileName, localInclude, alreadyIncluded))) {
-         // see if the include file can be found
-
-         if (oldFileDef) {
-            // add include dependency to the file in which the #include was found
-            bool ambig;
-
-            // change to absolute name
-            QSharedPointer<FileDef> incFd = findFileDef(&Doxy_Globals::inputNameDict, absIncFileName, ambig);
-
-            QSharedPointer<FileDef> temp;
-            if (ambig) {
-               temp = QSharedPointer<FileDef>();
-            } else {
-               temp = incFd;
-            }
+      fs = findFile(incFileName, localInclude, alreadyIncluded);
+      recordInclude(absIncFileName, incFileName, localInclude, (fs || alreadyIncluded) ? s_lastIncludeName : QString());
 
-            oldFileDef->addIncludeDependency(temp, incFileName, localInclude, s_isImported, false);
+      if (fs) {
+         // see if the include file can be found
+         addIncludeDependencies(oldFileDef, incFileName, absIncFileName, s_yyFileName, localInclude, s_isImported);
 
-            // add included by dependency
-            if (s_yyFileDef) {
-               s_yyFileDef->addIncludedByDependency(oldFileDef, oldFileDef->docName(), localInclude, s_isImported);
-            }
+         if (replayIncludeFile(oldFileName, fs->fileBuf)) {
+            // macro state of the header was restored from the macro database, return to the including file
+            setFileName(oldFileName);
+            s_yyLineNr = oldLineNr;
 
-         } else if (s_inputFileDef) {
-            s_inputFileDef->addIncludeDependency(QSharedPointer<FileDef>(), absIncFileName, localInclude, s_isImported, true);
+            QString lineStr = QString("# %1 \"%2\" 2").formatArg(s_yyLineNr).formatArg(QString(s_yyFileName));
+            outputArray(lineStr, lineStr.length());
 
+            return;
          }
 
          fs->bufState   = YY_CURRENT_BUFFER;
@@ -4469,6 +5586,7 @@ static void readIncludeFile(const QString &inc)
 
          // push the state on the stack
          s_includeStack.push(fs);
+         startMacroLog(fs);
 
          // set the scanner to the include file
 
@@ -4486,24 +5604,7 @@ static void readIncludeFile(const QString &inc)
          preYY_switch_to_buffer(preYY_create_buffer(0, YY_BUF_SIZE));
 
       } else {
-
-         if (oldFileDef) {
-            bool ambig;
-
-            // change to absolute name for bug 641336
-            QSharedPointer<FileDef> fd = findFileDef(&Doxy_Globals::inputNameDict, absIncFileName, ambig);
-
-            // add include dependency to the file in which the #include was found
-            oldFileDef->addIncludeDependency(ambig ? QSharedPointer<FileDef>() : fd, incFileName, localInclude, s_isImported, false);
-
-            // add included by dependency
-            if (fd) {
-               fd->addIncludedByDependency(oldFileDef, oldFileDef->docName(), localInclude, s_isImported);
-            }
-
-         } else if (s_inputFileDef) {
-            s_inputFileDef->addIncludeDependency(QSharedPointer<FileDef>(), absIncFileName, localInclude, s_isImported, true);
-         }
+         addIncludeDependencies(oldFileDef, incFileName, absIncFileName, QString(), localInclude, s_isImported);
 
          if (Debug::isFlagSet(Debug::Preprocessor)) {
             if (alreadyIncluded) {
@@ -4605,8 +5706,17 @@ static char resolveTrigraph(char c)
 #undef  YY_INPUT
 #define YY_INPUT(buf,result,max_size)   result = yyread(buf,max_size);
 
+// output is passed on in chunks of this size when streaming to the comment converter
+static const int s_outputChunkSize = 64 * 1024;
+
 static int yyread(char *buf, int max_size)
 {
+   if (s_outputBuffer != nullptr && s_outputString.size_storage() >= s_outputChunkSize) {
+      // the output is only appended to, so everything produced so far is final
+      s_outputBuffer->append(std::move(s_outputString));
+      s_outputString = QString();
+   }
+
    int len = max_size;
 
    const char *src = s_inputString.constData() + s_inputPosition;
@@ -5031,7 +6141,7 @@ YY_RULE_SETUP
       QSharedPointer<A_Define> def;
 
       if (skipFuncMacros && name != "Q_PROPERTY" && ! ( (s_includeStack.isEmpty() || s_curlyCount > 0) && s_macroExpansion &&
-                  (def = DefineManager::instance().isDefined(name)) && (! s_expandOnlyPredef || def->isPredefined)) ) {
+                  (def = lookupDefine(name)) && (! s_expandOnlyPredef || def->isPredefined)) ) {
 
          outputChar('\n');
          s_yyLineNr++;
@@ -5179,7 +6289,7 @@ YY_RULE_SETUP
       QSharedPointer<A_Define> def;
 
       if ((s_includeStack.isEmpty() || s_curlyCount > 0) && s_macroExpansion &&
-                  (def = DefineManager::instance().isDefined(text)) &&
+                  (def = lookupDefine(text)) &&
                   (! s_expandOnlyPredef || def->isPredefined)) {
 
          // fount it
@@ -5213,7 +6323,7 @@ YY_RULE_SETUP
       QSharedPointer<A_Define> def;
 
       if ((s_includeStack.isEmpty() || s_curlyCount > 0) && s_macroExpansion &&
-                  (def = DefineManager::instance().isDefined(text)) &&
+                  (def = lookupDefine(text)) &&
                    def->nargs == -1 && (! s_expandOnlyPredef || def->isPredefined)) {
 
             QString result = def->isPredefined ? def->m_definition : expandMacro(text);
@@ -5613,8 +6723,9 @@ YY_RULE_SETUP
 
       QSharedPointer<A_Define> def;
 
-      if ((def = DefineManager::instance().isDefined(text)) && ! def->nonRecursive) {
+      if ((def = lookupDefine(text)) && ! def->nonRecursive) {
          def->undef = true;
+         recordUndef(text);
       }
       BEGIN(Start);
    }
@@ -5696,7 +6807,7 @@ YY_RULE_SETUP
 {
       QString text = QString::fromUtf8(preYYtext);
 
-      if (DefineManager::instance().isDefined(text) || s_guardName == text) {
+      if (lookupDefine(text) || isGuardName(text)) {
          s_guardExpr+=" 1L ";
       } else {
          s_guardExpr+=" 0L ";
@@ -5711,7 +6822,7 @@ YY_RULE_SETUP
 {
       QString text = QString::fromUtf8(preYYtext);
 
-      if (DefineManager::instance().isDefined(text) || s_guardName == text){
+      if (lookupDefine(text) || isGuardName(text)) {
          s_guardExpr+=" 1L ";
       } else {
          s_guardExpr+=" 0L ";
@@ -6080,7 +7191,7 @@ YY_RULE_SETUP
       } else  {
          // define is a guard => hide
 
-         s_guardName = text;
+         setGuardName(text);
          s_lastGuardName.resize(0);
          BEGIN(Start);
       }
@@ -6816,13 +7927,14 @@ YY_RULE_SETUP
          addDefine();
       }
 
-      def = DefineManager::instance().isDefined(s_defName);
+      def = lookupDefine(s_defName);
 
       if (def == nullptr)  {
          // new define
 
          QSharedPointer<A_Define> nd = newDefine();
          DefineManager::instance().addDefine(s_yyFileName, nd);
+         recordDefine(nd);
 
       } else if (def) {
          // name already exists
@@ -7018,6 +8130,7 @@ case YY_STATE_EOF(SkipCond):
 
       } else {
          QSharedPointer<FileState> fs = s_includeStack.pop();
+         finishMacroLog(fs);
 
          YY_BUFFER_STATE oldBuf = YY_CURRENT_BUFFER;
          preYY_switch_to_buffer(fs->bufState );
@@ -8164,36 +9277,22 @@ void removePreProcessor()
 {
    s_expandedDict = QSharedPointer<DefineDict>();
    s_pathList.clear();
+   s_includeFileCache.clear();
+   s_includeContentCache.clear();
+   s_includeResolveCache.clear();
+   s_dirContents.clear();
+   s_macroDatabase.clear();
+   s_macroUsed.clear();
+   s_inputMacroDatabase.clear();
+   s_inputMacroUsed.clear();
+   s_expansionCache.clear();
 
    DefineManager::deleteInstance();
 }
 
-QString preprocessFile(const QString &fileName, const QString &input)
+// adds the macros from predefined-macros to the context of the file being preprocessed
+static void addPredefinedMacros(const QString &fileName)
 {
-   printlex(preYY_flex_debug, true, __FILE__, fileName);
-
-   s_macroExpansion   = Config::getBool("macro-expansion");
-   s_expandOnlyPredef = Config::getBool("expand-only-predefined");
-
-   s_skip        = false;
-   s_curlyCount  = 0;
-   s_nospaces    = false;
-
-   s_inputPosition  = 0;
-   s_inputString    = input;
-   s_outputString   = "";
-
-   s_includeStack.clear();
-   s_expandedDict->clear();
-   s_condStack.clear();
-
-   uint orgOffset = 0;
-
-   setFileName(fileName);
-
-   s_inputFileDef = s_yyFileDef;
-   DefineManager::instance().startContext(s_yyFileName);
-
    static bool firstTime = true;
 
    if (firstTime)  {
@@ -8333,6 +9432,40 @@ QString preprocessFile(const QString &fileName, const QString &input)
          }
       }
    }
+}
+
+QString preprocessFile(const QString &fileName, const QString &input, ChunkedBuffer *output)
+{
+   printlex(preYY_flex_debug, true, __FILE__, fileName);
+
+   s_macroExpansion   = Config::getBool("macro-expansion");
+   s_expandOnlyPredef = Config::getBool("expand-only-predefined");
+
+   if (macroDatabaseEnabled() && ! s_macroDatabaseLoaded) {
+      loadMacroDatabase();
+   }
+
+   s_skip        = false;
+   s_curlyCount  = 0;
+   s_nospaces    = false;
+
+   s_inputPosition  = 0;
+   s_inputString    = input;
+   s_outputString   = "";
+   s_outputBuffer   = output;
+
+   s_includeStack.clear();
+   s_expandedDict->clear();
+   s_condStack.clear();
+
+   uint orgOffset = 0;
+
+   setFileName(fileName);
+
+   s_inputFileDef = s_yyFileDef;
+   DefineManager::instance().startContext(s_yyFileName);
+
+   addPredefinedMacros(fileName);
 
    s_yyLineNr = 1;
    s_yyColNr  = 1;
@@ -8347,6 +9480,14 @@ QString preprocessFile(const QString &fileName, const QString &input)
    s_lastGuardName.resize(0);
    s_guardExpr = "";
 
+   const QString inputName = s_yyFileName;
+
+   if (macroDatabaseEnabled()) {
+      // used by the parse cache to restore the effect of preprocessing this file, see replayPreprocessFile()
+      s_inputMacroLog = QMakeShared<MacroLog>();
+      s_inputMacroLog->contentHash = QCryptographicHash::hash(input.toUtf8(), QCryptographicHash::Sha1);
+   }
+
    preYYlex();
 
    s_lexInit = true;
@@ -8366,16 +9507,94 @@ QString preprocessFile(const QString &fileName, const QString &input)
    // make sure we do not extend a \cond with missing \endcond over multiple files
    forceEndCondSection();
 
+   if (s_inputMacroLog && s_inputMacroLog->replayable) {
+      s_inputMacroDatabase.insert(inputName, s_inputMacroLog);
+      s_inputMacroUsed.insert(inputName);
+      s_macroDatabaseChanged = true;
+   }
+
+   s_inputMacroLog = QSharedPointer<MacroLog>();
+
    DefineManager::instance().endContext();
    printlex(preYY_flex_debug, false, __FILE__, fileName);
 
+   if (s_outputBuffer != nullptr) {
+      s_outputBuffer->append(std::move(s_outputString));
+      s_outputString = QString();
+      s_outputBuffer = nullptr;
+   }
+
    return s_outputString;
 }
 
+bool replayPreprocessFile(const QString &fileName, const QString &input)
+{
+   if (! macroDatabaseEnabled()) {
+      return false;
+   }
+
+   if (! s_macroDatabaseLoaded) {
+      loadMacroDatabase();
+   }
+
+   QSharedPointer<MacroLog> log = s_inputMacroDatabase.value(QFileInfo(fileName).absoluteFilePath());
+
+   if (log == nullptr || log->contentHash != QCryptographicHash::hash(input.toUtf8(), QCryptographicHash::Sha1)) {
+      return false;
+   }
+
+   // same state as preprocessFile() at the start of the file
+   s_skip       = false;
+   s_curlyCount = 0;
+
+   s_includeStack.clear();
+   s_condStack.clear();
+   s_levelGuard.clear();
+
+   setFileName(fileName);
+
+   s_inputFileDef = s_yyFileDef;
+   DefineManager::instance().startContext(s_yyFileName);
+
+   addPredefinedMacros(fileName);
+
+   s_expectGuard = determineSection(fileName) == Entry::HEADER_SEC;
+   s_guardName.resize(0);
+   s_lastGuardName.resize(0);
+
+   MacroReplayState state;
+   state.guardName = s_guardName;
+   state.includeStack.insert(s_yyFileName);
+
+   bool retval = checkMacroLog(state, s_yyFileName, log);
+
+   if (retval) {
+      applyMacroLog(state, s_yyFileName, log);
+      s_inputMacroUsed.insert(s_yyFileName);
+   }
+
+   DefineManager::instance().endContext();
+
+   return retval;
+}
+
 void preFreeScanner()
 {
    if (s_lexInit) {
       preYYlex_destroy();
    }
+
+   if (s_macroDatabaseLoaded) {
+      if (s_macroDatabaseChanged || s_macroUsed.size() != s_macroDatabase.size() ||
+            s_inputMacroUsed.size() != s_inputMacroDatabase.size()) {
+         saveMacroDatabase();
+      }
+
+      msg("Macro database used %d/%d\n", s_macroReplayed, s_macroReplayed + s_macroProcessed);
+   }
+
+   if (s_expansionHits + s_expansionMisses > 0) {
+      msg("Macro expansion cache used %d/%d\n", s_expansionHits, s_expansionHits + s_expansionMisses);
+   }
 }
 
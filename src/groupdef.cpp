@@ -34,6 +34,7 @@
 #include <message.h>
 #include <membergroup.h>
 #include <outputlist.h>
+#include <trace.h>
 #include <util.h>
 
 GroupDef::GroupDef(const QString &df, int dl, const QString &na, const QString &t, QString refFileName)
@@ -1072,6 +1073,7 @@ void GroupDef::writeSummaryLinks(OutputList &ol)
 void GroupDef::writeDocumentation(OutputList &ol)
 {
    QSharedPointer<GroupDef> self = sharedFrom(this);
+   Trace::Scope trace("group", name());
 
    // static bool generateTreeView = Config::getBool("generate-treeview");
 
@@ -31,6 +31,7 @@
 #include <language.h>
 #include <message.h>
 #include <msc.h>
+#include <outputcache.h>
 #include <outputgen.h>
 #include <parse_base.h>
 #include <plantuml.h>
@@ -2591,6 +2592,7 @@ void HtmlDocVisitor::startLink(const QString &ref, const QString &file, const QS
    } else {
       // local link
       m_t << "<a class=\"el\" ";
+      OutputCache::addLink(file, anchor);
    }
 
    m_t << "href=\"";
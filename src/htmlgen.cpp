@@ -37,6 +37,7 @@
 #include <logos.h>
 #include <language.h>
 #include <message.h>
+#include <outputcache.h>
 #include <resourcemgr.h>
 #include <util.h>
 
@@ -549,6 +550,7 @@ void HtmlCodeGenerator::_writeCodeLink(const QString &className, const QString &
 
    } else {
       m_streamX << "<a class=\"" << className << "\" ";
+      OutputCache::addLink(f, anchor);
    }
 
    m_streamX << "href=\"";
@@ -578,6 +580,10 @@ void HtmlCodeGenerator::_writeCodeLink(const QString &className, const QString &
 void HtmlCodeGenerator::writeTooltip(const QString &id, const DocLinkInfo &docInfo, const QString &decl,
                   const QString &desc, const SourceLinkInfo &defInfo, const SourceLinkInfo &declInfo)
 {
+   if (docInfo.ref.isEmpty()) {
+      OutputCache::addTooltip(docInfo.url, docInfo.anchor);
+   }
+
    m_streamX << "<div class=\"ttc\" id=\"" << id << "\">";
    m_streamX << "<div class=\"ttname\">";
 
@@ -1125,6 +1131,7 @@ void HtmlGenerator::startIndexItem(const QString &ref, const QString &f)
 
       } else {
          m_textStream << "<a class=\"el\" ";
+         OutputCache::addLink(f, QString());
       }
 
       m_textStream << "href=\"";
@@ -1173,6 +1180,7 @@ void HtmlGenerator::writeObjectLink(const QString &ref, const QString &f, const
 
    } else {
       m_textStream << "<a class=\"el\" ";
+      OutputCache::addLink(f, anchor);
    }
 
    m_textStream << "href=\"";
@@ -1194,6 +1202,8 @@ void HtmlGenerator::writeObjectLink(const QString &ref, const QString &f, const
 
 void HtmlGenerator::startTextLink(const QString &f, const QString &anchor)
 {
+   OutputCache::addLink(f, anchor);
+
    m_textStream << "<a href=\"";
 
    if (! f.isEmpty()) {
@@ -2894,6 +2904,8 @@ void HtmlGenerator::writeInheritedSectionTitle(const QString &id, const QString
    } else {
       classLink += "href=\"";
       classLink += m_relativePath;
+
+      OutputCache::addLink(file, anchor);
    }
 
    classLink += file + Doxy_Globals::htmlFileExtension + a;
@@ -0,0 +1,239 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QProcess>
+#include <QSharedPointer>
+
+#include <inputfilter.h>
+
+#include <config.h>
+#include <message.h>
+
+// upper limit for the combined size of the cached filter output in bytes
+static const int s_maxCacheSize = 64 * 1024 * 1024;
+
+// time in milliseconds a persistent filter may be silent before it is treated as not supporting the protocol,
+// filters which buffer their output such as sed or awk never answer
+static const int s_persistentFilterTimeout = 10000;
+
+QCache<QString, QByteArray> InputFilter::m_cache(s_maxCacheSize);
+QSet<QString> InputFilter::m_failedFilters;
+QMutex InputFilter::m_mutex;
+
+int InputFilter::m_hits   = 0;
+int InputFilter::m_misses = 0;
+
+/** Filter process which stays running and filters one file after another */
+class PersistentFilter
+{
+ public:
+   PersistentFilter(const QString &command);
+   ~PersistentFilter();
+
+   bool filterFile(const QString &fileName, QByteArray &output);
+
+   bool isValid() const {
+      return m_valid;
+   }
+
+ private:
+   bool fail();
+
+   QProcess m_process;
+   bool m_valid;
+};
+
+PersistentFilter::PersistentFilter(const QString &command)
+{
+   // messages of the filter go straight to stderr, reading them here could block the filter
+   m_process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+   m_process.start(command);
+
+   m_valid = m_process.waitForStarted(s_persistentFilterTimeout);
+}
+
+PersistentFilter::~PersistentFilter()
+{
+   if (m_process.state() != QProcess::NotRunning) {
+      // end of input tells the filter to exit
+      m_process.closeWriteChannel();
+
+      if (! m_process.waitForFinished(1000)) {
+         m_process.kill();
+         m_process.waitForFinished(-1);
+      }
+   }
+}
+
+// stops a filter which did not follow the protocol, the caller runs the filter once per file
+bool PersistentFilter::fail()
+{
+   m_valid = false;
+
+   m_process.kill();
+   m_process.waitForFinished();
+
+   return false;
+}
+
+bool PersistentFilter::filterFile(const QString &fileName, QByteArray &output)
+{
+   m_process.write(fileName.toUtf8() + "\n");
+
+   while (m_process.bytesToWrite() > 0) {
+      if (! m_process.waitForBytesWritten(s_persistentFilterTimeout)) {
+         return fail();
+      }
+   }
+
+   // first line holds the size of the output
+   while (! m_process.canReadLine()) {
+      if (! m_process.waitForReadyRead(s_persistentFilterTimeout)) {
+         return fail();
+      }
+   }
+
+   bool ok;
+   int size = m_process.readLine().trimmed().toInt(&ok);
+
+   if (! ok || size < 0) {
+      return fail();
+   }
+
+   output.clear();
+   output.reserve(size);
+
+   while (output.size() < size) {
+      if (m_process.bytesAvailable() == 0 && ! m_process.waitForReadyRead(s_persistentFilterTimeout)) {
+         return fail();
+      }
+
+      output += m_process.read(size - output.size());
+   }
+
+   return true;
+}
+
+bool InputFilter::filterFile(const QString &filter, const QString &fileName, QByteArray &output)
+{
+   QFileInfo fi(fileName);
+
+   if (! fi.isFile()) {
+      // let the filter report the problem
+      return runFilter(filter, fileName, output);
+   }
+
+   // the same file with the same size and modification time gives the same output
+   const QString key = filter + "\n" + fi.absoluteFilePath() + "\n" + QString::number(fi.size()) + "\n" +
+         QString::number(fi.lastModified().toMSecsSinceEpoch());
+
+   {
+      QMutexLocker locker(&m_mutex);
+      QByteArray *item = m_cache.object(key);
+
+      if (item != nullptr) {
+         ++m_hits;
+
+         // implicitly shared, no data is copied
+         output = *item;
+         return true;
+      }
+
+      ++m_misses;
+   }
+
+   if (! runFilter(filter, fileName, output)) {
+      return false;
+   }
+
+   QMutexLocker locker(&m_mutex);
+   m_cache.insert(key, new QByteArray(output), output.size());
+
+   return true;
+}
+
+bool InputFilter::runFilter(const QString &filter, const QString &fileName, QByteArray &output)
+{
+   static const bool persistent = Config::getBool("filter-persistent");
+
+   if (persistent) {
+      // a QProcess can only be used by the thread which created it, each thread starts its own filters
+      thread_local QHash<QString, QSharedPointer<PersistentFilter>> filterList;
+
+      QSharedPointer<PersistentFilter> process = filterList.value(filter);
+      bool isFailed;
+
+      {
+         QMutexLocker locker(&m_mutex);
+         isFailed = m_failedFilters.contains(filter);
+      }
+
+      if (process == nullptr && ! isFailed) {
+         process = QMakeShared<PersistentFilter>(filter);
+         filterList.insert(filter, process);
+      }
+
+      if (process != nullptr && ! isFailed) {
+
+         if (process->isValid() && process->filterFile(fileName, output)) {
+            return true;
+         }
+
+         filterList.remove(filter);
+
+         QMutexLocker locker(&m_mutex);
+
+         if (! m_failedFilters.contains(filter)) {
+            m_failedFilters.insert(filter);
+            warn_uncond("Filter %s does not support the persistent filter protocol, running it once per file\n",
+                  csPrintable(filter));
+         }
+      }
+   }
+
+   QString cmd = filter + " \"" + fileName + "\"";
+
+   QProcess filterProcess;
+   filterProcess.start(cmd);
+   filterProcess.waitForFinished(-1);
+
+   if (filterProcess.exitStatus() != QProcess::NormalExit) {
+      err("Unable to execute command:  %s\n", csPrintable(cmd));
+      return false;
+   }
+
+   output = filterProcess.readAllStandardOutput();
+
+   QByteArray errorMsg = filterProcess.readAllStandardError();
+
+   if (! errorMsg.isEmpty()) {
+      err("Possible filter problem: %s\n", errorMsg.constData());
+   }
+
+   return true;
+}
+
+void InputFilter::printStatistics()
+{
+   if (m_hits + m_misses > 0) {
+      msg("Input filter cache used %d/%d \n", m_hits, m_hits + m_misses);
+   }
+}
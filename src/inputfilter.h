@@ -0,0 +1,56 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#ifndef INPUTFILTER_H
+#define INPUTFILTER_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+/** Runs the filter programs configured for input and source files
+ *
+ *  The output of a filter is cached per filter command, file size and modification time, so a
+ *  file is only filtered once per run. When filter-persistent is set a filter is started once per
+ *  thread and is passed one file after another: DoxyPress writes the file name followed by a
+ *  newline to stdin, the filter answers with the size of the output in bytes on a line of its own
+ *  followed by the output. A filter which does not follow this protocol, or does not answer within
+ *  a few seconds, is stopped and run once per file.
+ */
+class InputFilter
+{
+ public:
+   // passes fileName through the filter command, returns false if the filter could not be run
+   static bool filterFile(const QString &filter, const QString &fileName, QByteArray &output);
+
+   static void printStatistics();
+
+ private:
+   static bool runFilter(const QString &filter, const QString &fileName, QByteArray &output);
+
+   static QCache<QString, QByteArray> m_cache;
+   static QSet<QString> m_failedFilters;
+   static QMutex m_mutex;
+
+   static int m_hits;
+   static int m_misses;
+};
+
+#endif
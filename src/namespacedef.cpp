@@ -27,6 +27,7 @@
 #include <message.h>
 #include <membergroup.h>
 #include <outputlist.h>
+#include <trace.h>
 #include <util.h>
 
 NamespaceDef::NamespaceDef(const QString &df, int dl, int dc, const QString &name,
@@ -548,6 +549,8 @@ void NamespaceDef::addNamespaceAttributes(OutputList &ol)
 
 void NamespaceDef::writeDocumentation(OutputList &ol)
 {
+   Trace::Scope trace("namespace", name());
+
    static const bool generateTreeView    = Config::getBool("generate-treeview");
    static const bool separateMemberPages = Config::getBool("separate-member-pages");
 
@@ -0,0 +1,719 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include <algorithm>
+
+#include <outputcache.h>
+
+#include <cite.h>
+#include <classdef.h>
+#include <config.h>
+#include <dirdef.h>
+#include <doxy_build_info.h>
+#include <doxy_globals.h>
+#include <filedef.h>
+#include <groupdef.h>
+#include <memberdef.h>
+#include <membergroup.h>
+#include <memberlist.h>
+#include <membername.h>
+#include <message.h>
+#include <namespacedef.h>
+#include <pagedef.h>
+
+static const QString s_manifestHeader = "doxy_pages 2";
+
+bool OutputCache::m_enabled = false;
+int  OutputCache::m_skipped = 0;
+
+QByteArray OutputCache::m_symbolSignature;
+
+QMultiHash<QString, QSharedPointer<Definition>> OutputCache::m_targets;
+QHash<QString, QString>    OutputCache::m_sections;
+QHash<QString, QByteArray> OutputCache::m_targetSignatures;
+
+bool          OutputCache::m_recording = false;
+QString       OutputCache::m_currentPage;
+QByteArray    OutputCache::m_currentSignature;
+QSet<QString> OutputCache::m_currentKeys;
+
+QHash<QString, OutputCache::PageInfo> OutputCache::m_oldPages;
+QHash<QString, OutputCache::PageInfo> OutputCache::m_newPages;
+
+static void addText(QCryptographicHash &hash, const QString &text)
+{
+   hash.addData(text.toUtf8());
+   hash.addData("\0", 1);
+}
+
+static void addNumber(QCryptographicHash &hash, int value)
+{
+   addText(hash, QString::number(value));
+}
+
+// hash iteration order is not stable, sort the keys
+template<class T>
+static void addNames(QCryptographicHash &hash, const QHash<QString, T> &dict)
+{
+   QStringList names = dict.keys();
+   std::sort(names.begin(), names.end());
+
+   for (const auto &item : names) {
+      addText(hash, item);
+   }
+}
+
+static void addFileContents(QCryptographicHash &hash, const QString &fileName)
+{
+   if (fileName.isEmpty()) {
+      return;
+   }
+
+   QFile file(fileName);
+
+   if (file.open(QIODevice::ReadOnly)) {
+      hash.addData(file.readAll());
+   }
+}
+
+// size and modification time of a file which is read while a page is written
+static void addFileStamp(QCryptographicHash &hash, const QString &fileName)
+{
+   QFileInfo fi(fileName);
+
+   addText(hash, fileName);
+   addText(hash, QString::number(fi.size()));
+   addText(hash, QString::number(fi.lastModified().toMSecsSinceEpoch()));
+}
+
+// files which \include, \image, \dotfile, \mscfile and \diafile can find
+static void addFileNames(QCryptographicHash &hash, const FileNameDict &fnDict)
+{
+   for (auto fn : fnDict) {
+      for (auto fd : *fn) {
+         addText(hash, fd->getFilePath());
+      }
+   }
+}
+
+static QString targetName(QSharedPointer<Definition> def)
+{
+   return def->getOutputFileBase() + "#" + def->anchor();
+}
+
+// data which shows up where another page links to the definition
+static void addLinkData(QCryptographicHash &hash, QSharedPointer<Definition> def)
+{
+   addText(hash, def->qualifiedName());
+   addText(hash, def->displayName());
+   addText(hash, def->briefDescription());
+   addNumber(hash, def->isLinkable());
+
+   switch (def->definitionType()) {
+
+      case Definition::TypeMember:
+      {
+         QSharedPointer<MemberDef> md = def.dynamicCast<MemberDef>();
+
+         addText(hash, md->typeString());
+         addText(hash, md->argsString());
+         addText(hash, md->excpString());
+         addText(hash, md->initializer());
+         break;
+      }
+
+      case Definition::TypeGroup:
+         addText(hash, def.dynamicCast<GroupDef>()->groupTitle());
+         break;
+
+      case Definition::TypePage:
+         addText(hash, def.dynamicCast<PageDef>()->title());
+         break;
+
+      default:
+         break;
+   }
+}
+
+// data which shows up in the tooltip of a source code link
+static void addTooltipData(QCryptographicHash &hash, QSharedPointer<Definition> def)
+{
+   addText(hash, def->briefDescription());
+   addText(hash, def->getSourceFileBase());
+   addText(hash, def->getSourceAnchor());
+   addNumber(hash, def->getStartBodyLine());
+
+   if (def->getBodyDef()) {
+      addText(hash, def->getBodyDef()->name());
+   }
+
+   if (def->definitionType() == Definition::TypeMember) {
+      addText(hash, def.dynamicCast<MemberDef>()->declaration());
+   }
+}
+
+// data which \copydoc, \copybrief and \copydetails insert
+static void addCopiedData(QCryptographicHash &hash, QSharedPointer<Definition> def)
+{
+   addText(hash, def->documentation());
+   addText(hash, def->briefDescription());
+   addText(hash, def->inbodyDocumentation());
+   addText(hash, def->getDefFileName());
+}
+
+static void addDefinitionData(QCryptographicHash &hash, QSharedPointer<Definition> def)
+{
+   static const bool inlineSources = Config::getBool("inline-source");
+
+   addText(hash, def->displayName());
+   addText(hash, def->documentation());
+   addText(hash, def->briefDescription());
+   addText(hash, def->inbodyDocumentation());
+   addText(hash, def->getDefFileName());
+
+   addNumber(hash, def->getDefLine());
+   addNumber(hash, def->getStartBodyLine());
+   addNumber(hash, def->getEndBodyLine());
+
+   if (inlineSources && def->getBodyDef()) {
+      // the body is copied from the source file, it can change without moving any line
+      addFileStamp(hash, def->getBodyDef()->getFilePath());
+   }
+
+   for (auto md : def->getReferencesMembers()) {
+      addText(hash, md->qualifiedName());
+   }
+
+   for (auto md : def->getReferencedByMembers()) {
+      addText(hash, md->qualifiedName());
+   }
+}
+
+static void addMemberData(QCryptographicHash &hash, QSharedPointer<MemberDef> md)
+{
+   addDefinitionData(hash, md);
+
+   addText(hash, md->typeString());
+   addText(hash, md->argsString());
+   addText(hash, md->excpString());
+   addText(hash, md->initializer());
+}
+
+template<class T>
+static void addScopeMembers(QCryptographicHash &hash, T scope)
+{
+   for (auto ml : scope->getMemberLists()) {
+      for (auto md : *ml) {
+         addMemberData(hash, md);
+      }
+   }
+
+   for (auto mg : scope->getMemberGroupSDict()) {
+      addText(hash, mg->header());
+      addText(hash, mg->documentation());
+
+      for (auto md : *mg->members()) {
+         addMemberData(hash, md);
+      }
+   }
+}
+
+QString OutputCache::manifestFileName()
+{
+   return Config::getString("html-output") + "/doxy_pages.txt";
+}
+
+void OutputCache::initialize()
+{
+   static const bool incremental = Config::getBool("incremental-output");
+
+   if (! incremental) {
+      return;
+   }
+
+   // skipped pages would be missing from these outputs or indexes
+   if (! Config::getBool("generate-html") || Config::getBool("generate-latex") || Config::getBool("generate-rtf") ||
+         Config::getBool("generate-man") || Config::getBool("generate-chm") || Config::getBool("generate-qthelp") ||
+         Config::getBool("generate-eclipse") || Config::getBool("generate-docset") ||
+         Doxy_Globals::searchIndexBase != nullptr) {
+
+      warn_uncond("Incremental output is only supported when HTML is the only output format "
+            "and server based search and HTML help indexes are disabled, all pages will be written\n");
+      return;
+   }
+
+   m_enabled = true;
+   m_symbolSignature = symbolSignature();
+
+   QFile file(manifestFileName());
+
+   if (file.open(QIODevice::ReadOnly)) {
+      QTextStream stream(&file);
+
+      if (stream.readLine() != s_manifestHeader) {
+         // written by an older version
+         return;
+      }
+
+      while (! stream.atEnd()) {
+         QStringList fields = stream.readLine().split("\t");
+
+         if (fields.count() >= 3) {
+            PageInfo info;
+
+            info.signature    = QByteArray::fromHex(fields[1].toLatin1());
+            info.dependencies = QByteArray::fromHex(fields[2].toLatin1());
+            info.keys         = fields.mid(3);
+
+            m_oldPages.insert(fields[0], info);
+         }
+      }
+   }
+}
+
+void OutputCache::finish()
+{
+   if (! m_enabled) {
+      return;
+   }
+
+   QString fileName = manifestFileName();
+   QFile file(fileName + ".tmp");
+
+   if (! file.open(QIODevice::WriteOnly)) {
+      err("Unable to write the page list %s, error: %d\n", csPrintable(file.fileName()), file.error());
+      return;
+   }
+
+   QTextStream stream(&file);
+   stream << s_manifestHeader << '\n';
+
+   for (auto iter = m_newPages.begin(); iter != m_newPages.end(); ++iter) {
+      const PageInfo &info = iter.value();
+
+      stream << iter.key() << '\t' << QString::fromLatin1(info.signature.toHex())
+             << '\t' << QString::fromLatin1(info.dependencies.toHex());
+
+      for (const auto &key : info.keys) {
+         stream << '\t' << key;
+      }
+
+      stream << '\n';
+   }
+
+   stream.flush();
+   file.close();
+
+   QFile::remove(fileName);
+
+   if (! QFile::rename(fileName + ".tmp", fileName)) {
+      err("Unable to rename the page list %s\n", csPrintable(fileName));
+   }
+
+   msg("Incremental output, %d of %d pages were unchanged\n", m_skipped, m_newPages.count());
+}
+
+void OutputCache::addTarget(QCryptographicHash &hash, QSharedPointer<Definition> def)
+{
+   const QString name = targetName(def);
+
+   m_targets.insert(name, def);
+
+   addText(hash, name);
+   addText(hash, def->qualifiedName());
+   addNumber(hash, def->isLinkable());
+}
+
+QByteArray OutputCache::symbolSignature()
+{
+   static const bool haveDot = Config::getBool("have-dot");
+
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+
+   hash.addData(Config::getCacheChecksum());
+   hash.addData(versionString.toUtf8());
+
+   addFileContents(hash, Config::getString("html-header"));
+   addFileContents(hash, Config::getString("html-footer"));
+   addFileContents(hash, Config::getString("layout-file"));
+
+   addFileNames(hash, Doxy_Globals::exampleNameDict);
+   addFileNames(hash, Doxy_Globals::imageNameDict);
+   addFileNames(hash, Doxy_Globals::dotFileNameDict);
+   addFileNames(hash, Doxy_Globals::mscFileNameDict);
+   addFileNames(hash, Doxy_Globals::diaFileNameDict);
+
+   for (auto cd : Doxy_Globals::classSDict) {
+      addTarget(hash, cd);
+
+      // inherited members are listed on the page of the derived class
+      if (cd->baseClasses()) {
+         for (auto bcd : *cd->baseClasses()) {
+            addText(hash, bcd->usedName);
+            addText(hash, bcd->classDef->name());
+         }
+      }
+
+      if (haveDot) {
+         addNames(hash, cd->usedImplementationClasses());
+         addNames(hash, cd->usedInterfaceClasses());
+         addNames(hash, cd->getTemplateInstances());
+      }
+   }
+
+   for (auto cd : Doxy_Globals::hiddenClasses) {
+      addTarget(hash, cd);
+   }
+
+   for (auto nd : Doxy_Globals::namespaceSDict) {
+      addTarget(hash, nd);
+   }
+
+   for (auto &fn : Doxy_Globals::inputNameList) {
+      for (auto fd : *fn) {
+         addTarget(hash, fd);
+
+         if (haveDot && fd->includeFileList()) {
+            for (const auto &item : *fd->includeFileList()) {
+               addText(hash, item.includeName);
+            }
+         }
+      }
+   }
+
+   for (auto dd : Doxy_Globals::directories) {
+      addTarget(hash, dd);
+   }
+
+   for (auto gd : Doxy_Globals::groupSDict) {
+      addTarget(hash, gd);
+   }
+
+   for (auto pd : Doxy_Globals::pageSDict) {
+      addTarget(hash, pd);
+   }
+
+   for (auto pd : Doxy_Globals::exampleSDict) {
+      addTarget(hash, pd);
+   }
+
+   for (auto mn : Doxy_Globals::memberNameSDict) {
+      for (auto md : *mn) {
+         addTarget(hash, md);
+
+         if (haveDot) {
+            // call and caller graphs
+            for (auto rmd : md->getReferencesMembers()) {
+               addText(hash, rmd->qualifiedName());
+            }
+         }
+      }
+   }
+
+   for (auto mn : Doxy_Globals::functionNameSDict) {
+      for (auto md : *mn) {
+         addTarget(hash, md);
+
+         if (haveDot) {
+            for (auto rmd : md->getReferencesMembers()) {
+               addText(hash, rmd->qualifiedName());
+            }
+         }
+      }
+   }
+
+   for (auto si : Doxy_Globals::sectionDict) {
+      addText(hash, si->label);
+      addText(hash, si->fileName);
+
+      m_sections.insert(si->fileName + "#" + si->label, si->title);
+   }
+
+   return hash.result();
+}
+
+QByteArray OutputCache::targetSignature(const QString &key)
+{
+   auto iter = m_targetSignatures.find(key);
+
+   if (iter != m_targetSignatures.end()) {
+      return iter.value();
+   }
+
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+
+   const int index      = key.indexOf(':');
+   const QString kind   = key.left(index);
+   const QString target = key.mid(index + 1);
+
+   if (kind == "file") {
+      addFileStamp(hash, target);
+
+   } else {
+      QList<QByteArray> list;
+
+      for (auto def : m_targets.values(target)) {
+         QCryptographicHash defHash(QCryptographicHash::Sha1);
+
+         if (kind == "link") {
+            addLinkData(defHash, def);
+
+         } else if (kind == "tooltip") {
+            addTooltipData(defHash, def);
+
+         } else {
+            addCopiedData(defHash, def);
+
+         }
+
+         list.append(defHash.result());
+      }
+
+      // definitions sharing a target are returned in any order
+      std::sort(list.begin(), list.end());
+
+      for (const auto &item : list) {
+         hash.addData(item);
+      }
+
+      if (kind == "link") {
+         addText(hash, m_sections.value(target));
+
+         static const QString citePrefix = "#" + CiteConsts::anchorPrefix;
+         const int citePos = target.indexOf(citePrefix);
+
+         if (citePos != -1) {
+            // number of the entry in the bibliography
+            addText(hash, Doxy_Globals::citeDict.find(target.mid(citePos + citePrefix.length())));
+         }
+      }
+   }
+
+   QByteArray result = hash.result();
+   m_targetSignatures.insert(key, result);
+
+   return result;
+}
+
+QByteArray OutputCache::dependencySignature(const QStringList &keys)
+{
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+
+   for (const auto &key : keys) {
+      addText(hash, key);
+      hash.addData(targetSignature(key));
+   }
+
+   return hash.result();
+}
+
+QByteArray OutputCache::pageSignature(QSharedPointer<Definition> def)
+{
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+
+   hash.addData(m_symbolSignature);
+   addDefinitionData(hash, def);
+
+   switch (def->definitionType()) {
+
+      case Definition::TypeClass:
+      {
+         QSharedPointer<ClassDef> cd = def.dynamicCast<ClassDef>();
+         addScopeMembers(hash, cd);
+
+         if (cd->subClasses()) {
+            for (auto bcd : *cd->subClasses()) {
+               addText(hash, bcd->classDef->name());
+            }
+         }
+
+         break;
+      }
+
+      case Definition::TypeFile:
+      {
+         QSharedPointer<FileDef> fd = def.dynamicCast<FileDef>();
+         addScopeMembers(hash, fd);
+
+         // result of file-version-filter
+         addText(hash, fd->getVersion());
+
+         if (fd->includeFileList()) {
+            for (const auto &item : *fd->includeFileList()) {
+               addText(hash, item.includeName);
+               addNumber(hash, item.local);
+            }
+         }
+
+         for (const auto &item : *fd->includedByFileList()) {
+            addText(hash, item.includeName);
+         }
+
+         break;
+      }
+
+      case Definition::TypeNamespace:
+         addScopeMembers(hash, def.dynamicCast<NamespaceDef>());
+         break;
+
+      case Definition::TypeGroup:
+      {
+         QSharedPointer<GroupDef> gd = def.dynamicCast<GroupDef>();
+         addScopeMembers(hash, gd);
+
+         for (auto cd : gd->getClasses()) {
+            addText(hash, cd->name());
+         }
+
+         for (auto nd : gd->getNamespaces()) {
+            addText(hash, nd->name());
+         }
+
+         for (auto fd : gd->getFiles()) {
+            addText(hash, fd->name());
+         }
+
+         if (gd->getPages()) {
+            for (auto pd : *gd->getPages()) {
+               // pages in a group are written on the page of the group
+               addText(hash, pd->name());
+               addText(hash, pd->title());
+               addDefinitionData(hash, pd);
+            }
+         }
+
+         if (gd->getSubGroups()) {
+            for (auto subGd : *gd->getSubGroups()) {
+               addText(hash, subGd->name());
+            }
+         }
+
+         break;
+      }
+
+      case Definition::TypePage:
+      {
+         QSharedPointer<PageDef> pd = def.dynamicCast<PageDef>();
+         addText(hash, pd->title());
+
+         if (pd->getSubPages()) {
+            for (auto subPd : *pd->getSubPages()) {
+               addText(hash, subPd->name());
+            }
+         }
+
+         break;
+      }
+
+      default:
+         break;
+   }
+
+   return hash.result();
+}
+
+bool OutputCache::isUpToDate(QSharedPointer<Definition> def)
+{
+   if (! m_enabled) {
+      return false;
+   }
+
+   static const QString htmlOutput = Config::getString("html-output");
+
+   const QString fileBase  = def->getOutputFileBase();
+   const QByteArray newSig = pageSignature(def);
+
+   auto iter = m_oldPages.find(fileBase);
+
+   if (iter != m_oldPages.end() && iter.value().signature == newSig &&
+         iter.value().dependencies == dependencySignature(iter.value().keys)) {
+      QFileInfo fi(htmlOutput + "/" + fileBase + Doxy_Globals::htmlFileExtension);
+
+      if (fi.exists()) {
+         m_newPages.insert(fileBase, iter.value());
+         ++m_skipped;
+
+         return true;
+      }
+   }
+
+   m_recording        = true;
+   m_currentPage      = fileBase;
+   m_currentSignature = newSig;
+   m_currentKeys.clear();
+
+   return false;
+}
+
+void OutputCache::endPage()
+{
+   if (! m_recording) {
+      return;
+   }
+
+   m_recording = false;
+
+   PageInfo info;
+
+   info.signature = m_currentSignature;
+
+   for (const auto &key : m_currentKeys) {
+      info.keys.append(key);
+   }
+
+   std::sort(info.keys.begin(), info.keys.end());
+   info.dependencies = dependencySignature(info.keys);
+
+   m_newPages.insert(m_currentPage, info);
+}
+
+void OutputCache::addDependency(const QString &key)
+{
+   if (m_recording) {
+      m_currentKeys.insert(key);
+   }
+}
+
+void OutputCache::addLink(const QString &file, const QString &anchor)
+{
+   // the own page is covered by its signature
+   if (m_recording && ! file.isEmpty() && file != m_currentPage) {
+      addDependency("link:" + file + "#" + anchor);
+   }
+}
+
+void OutputCache::addTooltip(const QString &file, const QString &anchor)
+{
+   addDependency("tooltip:" + file + "#" + anchor);
+}
+
+void OutputCache::addCopiedDocs(QSharedPointer<Definition> def)
+{
+   addDependency("docs:" + targetName(def));
+}
+
+void OutputCache::addFile(const QString &fileName)
+{
+   addDependency("file:" + fileName);
+}
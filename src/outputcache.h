@@ -0,0 +1,99 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#ifndef OUTPUTCACHE_H
+#define OUTPUTCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+class Definition;
+class QCryptographicHash;
+
+/** Decides which documentation pages need to be written again
+ *
+ *  Each page has its own signature, covering the documentation, declarations and source locations
+ *  of its definition and members. While a page is written, the links, tooltips, copied documentation
+ *  and files it uses are recorded as its dependencies, and stored with a signature of their current
+ *  state. On the next run, a page is only skipped when its own signature is unchanged, every recorded
+ *  dependency is unchanged, and the HTML file still exists.
+ *
+ *  A page can also depend on names which did not resolve, or on a graph drawn by dot. Neither is
+ *  recorded, so a symbol signature covers the settings, the names, output files and anchors of every
+ *  definition and section, and the class relations. Any change to these writes every page again.
+ */
+class OutputCache
+{
+ public:
+   static void initialize();
+   static void finish();
+
+   // returns true if the page for this definition does not have to be written,
+   // otherwise records the dependencies of the page until endPage() is called
+   static bool isUpToDate(QSharedPointer<Definition> def);
+   static void endPage();
+
+   // called while a page is written
+   static void addLink(const QString &file, const QString &anchor);
+   static void addTooltip(const QString &file, const QString &anchor);
+   static void addCopiedDocs(QSharedPointer<Definition> def);
+   static void addFile(const QString &fileName);
+
+ private:
+   struct PageInfo {
+      QByteArray signature;
+      QByteArray dependencies;
+      QStringList keys;
+   };
+
+   static void addDependency(const QString &key);
+   static void addTarget(QCryptographicHash &hash, QSharedPointer<Definition> def);
+
+   static QByteArray pageSignature(QSharedPointer<Definition> def);
+   static QByteArray symbolSignature();
+   static QByteArray targetSignature(const QString &key);
+   static QByteArray dependencySignature(const QStringList &keys);
+
+   static QString manifestFileName();
+
+   static bool m_enabled;
+   static int  m_skipped;
+
+   static QByteArray m_symbolSignature;
+
+   // output file and anchor of each definition and section which can be linked to
+   static QMultiHash<QString, QSharedPointer<Definition>> m_targets;
+   static QHash<QString, QString>    m_sections;
+   static QHash<QString, QByteArray> m_targetSignatures;
+
+   // page which is being written
+   static bool          m_recording;
+   static QString       m_currentPage;
+   static QByteArray    m_currentSignature;
+   static QSet<QString> m_currentKeys;
+
+   static QHash<QString, PageInfo> m_oldPages;
+   static QHash<QString, PageInfo> m_newPages;
+};
+
+#endif
@@ -17,14 +17,150 @@
 *************************************************************************/
 
 #include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QWaitCondition>
 
 #include <stdlib.h>
 #include <cassert>
 
+#include <config.h>
 #include <doxy_globals.h>
 #include <outputgen.h>
 #include <message.h>
 
+// upper limit for the size of the pages waiting to be written
+static const qint64 s_maxQueuedBytes = 64 * 1024 * 1024;
+
+/** Writes finished output files on a background thread
+ *
+ *  Only the file I/O is asynchronous. The generators and the documentation parser share static
+ *  state so the pages are still rendered one at a time on the main thread. Pages are written in
+ *  the order they were finished, enqueue() blocks while the queue holds more than s_maxQueuedBytes.
+ */
+class OutputFileWriter : public QThread
+{
+ public:
+   static OutputFileWriter *instance();
+
+   void enqueue(const QString &fileName, QByteArray data);
+   bool waitForFiles();
+
+ protected:
+   void run() override;
+
+ private:
+   OutputFileWriter()
+      : m_pending(0), m_queuedBytes(0), m_failed(false), m_stop(false)
+   { }
+
+   QQueue<QPair<QString, QByteArray>> m_queue;
+
+   int    m_pending;
+   qint64 m_queuedBytes;
+   bool   m_failed;
+   bool   m_stop;
+
+   QMutex          m_mutex;
+   QWaitCondition  m_workAvailable;
+   QWaitCondition  m_queueEmpty;
+   QWaitCondition  m_queueSpace;
+};
+
+OutputFileWriter *OutputFileWriter::instance()
+{
+   static OutputFileWriter *writer = new OutputFileWriter;
+   return writer;
+}
+
+void OutputFileWriter::enqueue(const QString &fileName, QByteArray data)
+{
+   QMutexLocker locker(&m_mutex);
+
+   if (! isRunning()) {
+      m_stop = false;
+      start();
+   }
+
+   // a page larger than the limit is still accepted once the queue is empty
+   while (m_queuedBytes > 0 && m_queuedBytes + data.size() > s_maxQueuedBytes) {
+      m_queueSpace.wait(&m_mutex);
+   }
+
+   m_queuedBytes += data.size();
+   m_queue.enqueue(qMakePair(fileName, std::move(data)));
+   ++m_pending;
+
+   m_workAvailable.wakeOne();
+}
+
+bool OutputFileWriter::waitForFiles()
+{
+   {
+      QMutexLocker locker(&m_mutex);
+
+      while (m_pending > 0) {
+         m_queueEmpty.wait(&m_mutex);
+      }
+
+      m_stop = true;
+      m_workAvailable.wakeOne();
+   }
+
+   // the thread is started again by the next call to enqueue()
+   wait();
+
+   QMutexLocker locker(&m_mutex);
+
+   bool retval = ! m_failed;
+   m_failed    = false;
+
+   return retval;
+}
+
+void OutputFileWriter::run()
+{
+   while (true) {
+      QPair<QString, QByteArray> item;
+
+      {
+         QMutexLocker locker(&m_mutex);
+
+         while (m_queue.isEmpty() && ! m_stop) {
+            m_workAvailable.wait(&m_mutex);
+         }
+
+         if (m_queue.isEmpty()) {
+            return;
+         }
+
+         item = m_queue.dequeue();
+      }
+
+      QFile file(item.first);
+      bool ok = file.open(QIODevice::WriteOnly) && file.write(item.second) == item.second.size();
+
+      if (! ok) {
+         err("Unable to write file %s, error: %d\n", csPrintable(item.first), file.error());
+      }
+
+      QMutexLocker locker(&m_mutex);
+
+      if (! ok) {
+         m_failed = true;
+      }
+
+      --m_pending;
+      m_queuedBytes -= item.second.size();
+      m_queueSpace.wakeAll();
+
+      if (m_pending == 0) {
+         m_queueEmpty.wakeAll();
+      }
+   }
+}
+
 OutputGenerator::OutputGenerator()
 {
    active = true;
@@ -36,7 +172,19 @@ OutputGenerator::~OutputGenerator()
 
 void OutputGenerator::startPlainFile(const QString &name)
 {
+   static const bool asyncWrite = Config::getBool("output-async-write");
+
    m_fileName = m_dir + "/" + name;
+
+   if (asyncWrite) {
+      // page is collected in memory and passed to the writer thread by endPlainFile()
+      m_buffer.setData(QByteArray());
+      m_buffer.open(QIODevice::WriteOnly);
+
+      m_textStream.setDevice(&m_buffer);
+      return;
+   }
+
    m_file.setFileName(m_fileName);
 
    if (! m_file.open(QIODevice::WriteOnly)) {
@@ -51,12 +199,30 @@ void OutputGenerator::endPlainFile()
 {
    m_textStream.setDevice(0);
 
-   m_fileName = "";
+   if (m_buffer.isOpen()) {
+      m_buffer.close();
+
+      OutputFileWriter::instance()->enqueue(m_fileName, m_buffer.data());
+      m_buffer.setData(QByteArray());
+
+   } else {
+      m_file.close();
+
+   }
 
-   m_file.close();
+   m_fileName = "";
    m_file.setFileName(m_fileName);
 }
 
+void OutputGenerator::waitForFiles()
+{
+   static const bool asyncWrite = Config::getBool("output-async-write");
+
+   if (asyncWrite && ! OutputFileWriter::instance()->waitForFiles()) {
+      Doxy_Work::stopDoxyPress();
+   }
+}
+
 void OutputGenerator::pushGeneratorState()
 {
    genStack.push( isEnabled() );
@@ -19,6 +19,7 @@
 #ifndef OUTPUTGEN_H
 #define OUTPUTGEN_H
 
+#include <QBuffer>
 #include <QFile>
 #include <QStack>
 #include <QTextStream>
@@ -323,6 +324,9 @@ class OutputGenerator : public BaseOutputDocInterface
    void startPlainFile(const QString &name);
    void endPlainFile();
 
+   // blocks until all pages queued for the background writer are on disk
+   static void waitForFiles();
+
    bool isEnabled() const {
       return active;
    }
@@ -479,6 +483,7 @@ class OutputGenerator : public BaseOutputDocInterface
    QTextStream m_textStream;
 
    QFile    m_file;
+   QBuffer  m_buffer;
    QString  m_fileName;
    QString  m_dir;
    bool     active;
@@ -17,8 +17,17 @@
 *************************************************************************/
 
 #include <QByteArray>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
 #include <QHash>
+#include <QMutex>
+#include <QQueue>
 #include <QSet>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -53,6 +62,234 @@ QMap<QString, QSharedPointer<Entry>> s_entryMap;
 
 static void writeLineNumber(CodeOutputInterface &ol, QSharedPointer<FileDef> fd, uint line);
 
+/** Translation unit and the buffers which were passed to libClang for its files
+ */
+struct ClangSavedUnit {
+   CXIndex              index    = nullptr;
+   CXTranslationUnit    tu       = nullptr;
+   QByteArray          *sources  = nullptr;
+   CXUnsavedFile       *ufs      = nullptr;
+   uint                 numFiles = 0;
+   QHash<QString, uint> fileMapping;
+   QStringList          includeFiles;
+};
+
+/** Translation unit parsed while extracting the entries of a file, written to disk so writing the
+ *  source code of the same file does not run the clang frontend again
+ */
+struct ClangUnitFile {
+   QString    fileName;
+   QByteArray key;
+};
+
+static QHash<QString, ClangUnitFile> s_savedUnits;
+
+// holds the saved translation units, created by the first unit which is saved
+static QTemporaryDir *s_unitDir = nullptr;
+
+// identifies the input of a translation unit, the main file is the text shown in the source browser
+static QByteArray unitKey(const QByteArray &source, const QStringList &includeFiles)
+{
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+
+   hash.addData(source);
+
+   for (const auto &item : includeFiles) {
+      hash.addData(item.toUtf8());
+      hash.addData("\n", 1);
+   }
+
+   return hash.result();
+}
+
+static void disposeUnit(ClangSavedUnit &unit)
+{
+   if (unit.tu) {
+      clang_disposeTranslationUnit(unit.tu);
+   }
+
+   if (unit.index) {
+      clang_disposeIndex(unit.index);
+   }
+
+   for (uint i = 0; i < unit.numFiles; i++) {
+      free((void *)unit.ufs[i].Filename);
+   }
+
+   delete[] unit.ufs;
+   delete[] unit.sources;
+}
+
+/** Input and result of parsing one translation unit
+ */
+struct ClangUnitJob {
+   QString              fileName;
+   QByteArray           mainSource;
+   QStringList          includeFiles;
+   std::vector<QString> argList;
+   bool                 buildAST = false;
+
+   ClangSavedUnit       unit;
+   CXErrorCode          errorCode = CXError_Failure;
+
+   CXToken             *tokens    = nullptr;
+   uint                 numTokens = 0;
+   CXCursor            *cursors   = nullptr;
+
+   std::unique_ptr<clang::ASTUnit> ast;
+
+   bool                 finished  = false;
+};
+
+static void parseUnit(ClangUnitJob &job);
+
+static void disposeJob(ClangUnitJob &job)
+{
+   if (job.tokens != nullptr) {
+      clang_disposeTokens(job.unit.tu, job.tokens, job.numTokens);
+   }
+
+   delete[] job.cursors;
+
+   job.ast.reset();
+   disposeUnit(job.unit);
+}
+
+/** Parses translation units on a pool of worker threads ahead of ClangParser::start(). Jobs are
+ *  parsed in the order they were added, the libTooling AST is visited later in the calling thread
+ *  since the entries are shared between translation units.
+ */
+class ClangUnitPool
+{
+ public:
+   ClangUnitPool(int numThreads);
+   ~ClangUnitPool();
+
+   void add(ClangUnitJob *job);
+
+   // removes the job for fileName and waits until it was parsed, returns nullptr if there is none
+   ClangUnitJob *take(const QString &fileName);
+
+ private:
+   class Worker : public QThread
+   {
+    public:
+      Worker(ClangUnitPool *owner)
+         : m_owner(owner)
+      { }
+
+      void run() override {
+         m_owner->work();
+      }
+
+    private:
+      ClangUnitPool *m_owner;
+   };
+
+   void work();
+
+   QQueue<ClangUnitJob *>         m_pending;
+   QHash<QString, ClangUnitJob *> m_jobs;
+
+   bool m_stop;
+
+   QMutex          m_mutex;
+   QWaitCondition  m_jobAdded;
+   QWaitCondition  m_jobFinished;
+
+   QList<Worker *> m_workers;
+};
+
+ClangUnitPool::ClangUnitPool(int numThreads)
+   : m_stop(false)
+{
+   for (int i = 0; i < numThreads; ++i) {
+      Worker *thread = new Worker(this);
+      thread->start();
+
+      m_workers.append(thread);
+   }
+}
+
+ClangUnitPool::~ClangUnitPool()
+{
+   {
+      QMutexLocker locker(&m_mutex);
+
+      // jobs which were not started are dropped
+      m_pending.clear();
+      m_stop = true;
+
+      m_jobAdded.wakeAll();
+   }
+
+   for (auto thread : m_workers) {
+      thread->wait();
+      delete thread;
+   }
+
+   for (auto job : m_jobs) {
+      disposeJob(*job);
+      delete job;
+   }
+}
+
+void ClangUnitPool::add(ClangUnitJob *job)
+{
+   QMutexLocker locker(&m_mutex);
+
+   if (m_jobs.contains(job->fileName)) {
+      delete job;
+      return;
+   }
+
+   m_jobs.insert(job->fileName, job);
+   m_pending.enqueue(job);
+
+   m_jobAdded.wakeOne();
+}
+
+ClangUnitJob *ClangUnitPool::take(const QString &fileName)
+{
+   QMutexLocker locker(&m_mutex);
+
+   ClangUnitJob *job = m_jobs.take(fileName);
+
+   if (job == nullptr) {
+      return nullptr;
+   }
+
+   while (! job->finished) {
+      m_jobFinished.wait(&m_mutex);
+   }
+
+   return job;
+}
+
+void ClangUnitPool::work()
+{
+   QMutexLocker locker(&m_mutex);
+
+   while (true) {
+      while (m_pending.isEmpty() && ! m_stop) {
+         m_jobAdded.wait(&m_mutex);
+      }
+
+      if (m_pending.isEmpty()) {
+         return;
+      }
+
+      ClangUnitJob *job = m_pending.dequeue();
+
+      locker.unlock();
+      parseUnit(*job);
+      locker.relock();
+
+      job->finished = true;
+      m_jobFinished.wakeAll();
+   }
+}
+
 class ClangParser::Private
 {
  public:
@@ -60,11 +297,20 @@ class ClangParser::Private
 
    Private()
       : sources(nullptr), numFiles(0), numTokens(0), curLine(0), curToken(0),
-        tu(0), tokens(nullptr), cursors(nullptr), ufs(nullptr), detectedLang(Detected_Cpp)
+        index(nullptr), tu(0), tokens(nullptr), cursors(nullptr), ufs(nullptr),
+        detectedLang(Detected_Cpp), unconverted(false), keepUnit(false), pool(nullptr)
    {
    }
 
-   int getCurrentTokenLine();
+   // builds the line and spelling tables for the current tokens, done once per file on the first lookup
+   void buildTokenIndex();
+   void clearTokenIndex();
+
+   // loads the translation unit saved for name if it was built from the same input
+   bool restoreUnit(const QString &name, const QByteArray &source, const QStringList &includeFiles);
+
+   // creates the tokens and cursors for a file which is part of the translation unit
+   void tokenizeFile(const QString &name, uint length);
 
    QString fileName;
    QByteArray *sources;
@@ -81,27 +327,143 @@ class ClangParser::Private
    CXUnsavedFile     *ufs;
 
    QHash<QString, uint> fileMapping;
+   QStringList includeFiles;
+
+   // line of each token, index of the first token on each line, spelling of each token
+   QVector<uint> tokenLines;
+   QVector<uint> lineFirstToken;
+   QVector<QByteArray> tokenSpellings;
+
    DetectedLang detectedLang;
+
+   // set by setUnconverted(), the next text passed to start() is the input file without converted comments
+   bool unconverted;
+
+   // save the translation unit to disk in finish() before disposing it
+   bool keepUnit;
+
+   // file the current translation unit was loaded from, removed in finish()
+   QString unitFileName;
+
+   // worker threads used by prefetch(), nullptr when parsing in the calling thread
+   ClangUnitPool *pool;
 };
 
-int ClangParser::Private::getCurrentTokenLine()
+void ClangParser::Private::buildTokenIndex()
 {
-   if (numTokens == 0) {
-      return 1;
+   if (numTokens == 0 || ! tokenLines.isEmpty()) {
+      return;
    }
 
-   // guard against filters that reduce the number of lines
-   uint retval;
-   uint c;
+   tokenLines.resize(numTokens);
+   tokenSpellings.resize(numTokens);
+
+   uint maxLine = 0;
+
+   for (uint i = 0; i < numTokens; ++i) {
+      uint line;
+      uint column;
+
+      CXSourceLocation start = clang_getTokenLocation(tu, tokens[i]);
+      clang_getSpellingLocation(start, 0, &line, &column, 0);
 
-   if (curToken >= numTokens) {
-      curToken = numTokens - 1;
+      CXString tokenString = clang_getTokenSpelling(tu, tokens[i]);
+
+      tokenLines[i]     = line;
+      tokenSpellings[i] = QByteArray(clang_getCString(tokenString));
+
+      clang_disposeString(tokenString);
+
+      if (line > maxLine) {
+         maxLine = line;
+      }
    }
 
-   CXSourceLocation start = clang_getTokenLocation(tu, tokens[curToken]);
-   clang_getSpellingLocation(start, 0, &retval, &c, 0);
+   lineFirstToken.fill(numTokens, maxLine + 1);
 
-   return retval;
+   for (uint i = numTokens; i > 0; --i) {
+      lineFirstToken[tokenLines[i - 1]] = i - 1;
+   }
+}
+
+void ClangParser::Private::clearTokenIndex()
+{
+   tokenLines.clear();
+   lineFirstToken.clear();
+   tokenSpellings.clear();
+}
+
+bool ClangParser::Private::restoreUnit(const QString &name, const QByteArray &source, const QStringList &includeFiles)
+{
+   auto iter = s_savedUnits.find(name);
+
+   if (iter == s_savedUnits.end()) {
+      return false;
+   }
+
+   ClangUnitFile unitFile = iter.value();
+   s_savedUnits.erase(iter);
+
+   if (unitFile.key != unitKey(source, includeFiles)) {
+      // source code differs from the text which was parsed
+      QFile::remove(unitFile.fileName);
+      return false;
+   }
+
+   index = clang_createIndex(false, false);
+
+   if (clang_createTranslationUnit2(index, unitFile.fileName.toUtf8().constData(), &tu) != CXError_Success) {
+      clang_disposeIndex(index);
+      QFile::remove(unitFile.fileName);
+
+      index = nullptr;
+      tu    = nullptr;
+
+      return false;
+   }
+
+   // buffers of the include files are stored in the unit, only the length of the main file is needed
+   numFiles = 1;
+   sources  = new QByteArray[1];
+   ufs      = new CXUnsavedFile[1];
+
+   sources[0]      = source;
+   ufs[0].Filename = strdup(name.toUtf8().constData());
+   ufs[0].Contents = sources[0].constData();
+   ufs[0].Length   = sources[0].length();
+
+   fileMapping.clear();
+   this->includeFiles = includeFiles;
+   unitFileName       = unitFile.fileName;
+
+   fileName = name;
+   curLine  = 1;
+   curToken = 0;
+
+   return true;
+}
+
+static void tokenizeFile(CXTranslationUnit tu, const QString &name, uint length,
+                  CXToken **tokens, uint *numTokens, CXCursor **cursors)
+{
+   CXFile f = clang_getFile(tu, name.toUtf8().constData());
+
+   CXSourceLocation fileBegin = clang_getLocationForOffset(tu, f, 0);
+   CXSourceLocation fileEnd   = clang_getLocationForOffset(tu, f, length);
+   CXSourceRange    fileRange = clang_getRange(fileBegin, fileEnd);
+
+   // generate tokens for the file
+   clang_tokenize(tu, fileRange, tokens, numTokens);
+
+   // generate cursors for each token
+   *cursors = new CXCursor[*numTokens];
+   clang_annotateTokens(tu, *tokens, *numTokens, *cursors);
+}
+
+void ClangParser::Private::tokenizeFile(const QString &name, uint length)
+{
+   clearTokenIndex();
+   ::tokenizeFile(tu, name, length, &tokens, &numTokens, &cursors);
 }
 
 ClangParser *ClangParser::instance()
@@ -117,6 +479,7 @@ ClangParser::ClangParser()
 
 ClangParser::~ClangParser()
 {
+   removeSavedUnits();
    delete p;
 }
 
@@ -507,8 +870,228 @@ static bool documentKind(CXCursor cursor)
    return false;
 }
 
-// ** entry point
-void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStringList &includeFiles, QSharedPointer<Entry> root)
+// builds a precompiled header for the headers listed in clang-pch-headers, once for each set of
+// arguments, argList must end with "-x" and the language id
+static QString precompiledHeader(const std::vector<QString> &argList)
+{
+   static const QStringList pchHeaders = Config::getList("clang-pch-headers");
+   static const QString parseCacheDir  = Config::getString("parse-cache-dir");
+   static const QString outputDir      = Config::getString("output-dir");
+
+   // arguments, file name of the precompiled header or empty if it could not be built
+   static QHash<QString, QString> pchFiles;
+
+   if (pchHeaders.isEmpty()) {
+      return QString();
+   }
+
+   QString key;
+
+   for (const auto &item : argList) {
+      key += item + "\n";
+   }
+
+   auto iter = pchFiles.find(key);
+
+   if (iter != pchFiles.end()) {
+      return iter.value();
+   }
+
+   QString retval;
+
+   QString dirName = parseCacheDir.isEmpty() ? outputDir : parseCacheDir;
+   QString name    = QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex());
+
+   QString headerName = dirName + "/doxy_pch_" + name + ".h";
+   QString pchName    = dirName + "/doxy_pch_" + name + ".pch";
+
+   // the header is written to disk since clang validates the input files when loading the precompiled header
+   QString text;
+
+   for (const auto &item : pchHeaders) {
+      if (item.startsWith('<') || item.startsWith('"')) {
+         text += "#include " + item + "\n";
+      } else {
+         text += "#include <" + item + ">\n";
+      }
+   }
+
+   QDir().mkpath(dirName);
+   QFile file(headerName);
+
+   if (file.open(QIODevice::WriteOnly)) {
+      file.write(text.toUtf8());
+      file.close();
+
+      // parse as a header of the same language
+      std::vector<QString> pchArgs = argList;
+      pchArgs.back() += "-header";
+      pchArgs.push_back(headerName);
+
+      std::vector<const char *> argv;
+
+      for (auto &item : pchArgs) {
+         argv.push_back(item.constData());
+      }
+
+      CXIndex index        = clang_createIndex(false, false);
+      CXTranslationUnit tu = nullptr;
+
+      CXErrorCode errorCode = clang_parseTranslationUnit2(index, 0, &argv[0], argv.size(), nullptr, 0,
+                  CXTranslationUnit_Incomplete | CXTranslationUnit_ForSerialization, &tu);
+
+      if (errorCode == CXError_Success && tu != nullptr) {
+         if (clang_saveTranslationUnit(tu, pchName.toUtf8().constData(), clang_defaultSaveOptions(tu)) == CXSaveError_None) {
+            retval = pchName;
+         }
+      }
+
+      if (tu != nullptr) {
+         clang_disposeTranslationUnit(tu);
+      }
+
+      clang_disposeIndex(index);
+   }
+
+   if (retval.isEmpty()) {
+      err("Unable to build the precompiled header for clang-pch-headers in %s, parsing without it\n", csPrintable(dirName));
+   }
+
+   pchFiles.insert(key, retval);
+
+   return retval;
+}
+
+static QMutex                     s_includeMutex;
+static QHash<QString, QByteArray> s_includeSources;
+static QSet<QString>              s_includesOnDisk;
+
+// returns true and the text clang must see for an include file when it differs from the file on disk,
+// otherwise clang opens the file itself and only if the file is actually included
+static bool includeSource(const QString &fileName, QByteArray &source)
+{
+   static bool filterSourceFiles = Config::getBool("filter-source-files");
+
+   {
+      QMutexLocker locker(&s_includeMutex);
+
+      if (s_includesOnDisk.contains(fileName)) {
+         return false;
+      }
+
+      auto iter = s_includeSources.find(fileName);
+
+      if (iter != s_includeSources.end()) {
+         source = iter.value();
+         return true;
+      }
+   }
+
+   // loaded once per run, two translation units may both load a file the first time it is needed
+   QByteArray text = detab(fileToString(fileName, filterSourceFiles, true)).toUtf8();
+
+   QFile file(fileName);
+   bool sameAsDisk = file.open(QIODevice::ReadOnly) && file.readAll() == text;
+
+   QMutexLocker locker(&s_includeMutex);
+
+   if (sameAsDisk) {
+      s_includesOnDisk.insert(fileName);
+      return false;
+   }
+
+   s_includeSources.insert(fileName, text);
+   source = text;
+
+   return true;
+}
+
+// parses a translation unit, called from start() or from a worker thread of ClangUnitPool
+static void parseUnit(ClangUnitJob &job)
+{
+   ClangSavedUnit &unit = job.unit;
+
+   // exclude PCH files, disable diagnostics
+   unit.index = clang_createIndex(false, false);
+
+   // include files which were filtered or contain tabs are passed as files in memory
+   QList<QPair<QString, QByteArray>> mappedFiles;
+
+   for (const auto &item : job.includeFiles) {
+      QByteArray source;
+
+      if (includeSource(item, source)) {
+         mappedFiles.append(qMakePair(item, source));
+      }
+   }
+
+   uint numUnsavedFiles = mappedFiles.count() + 1;
+
+   unit.numFiles     = numUnsavedFiles;
+   unit.sources      = new QByteArray[numUnsavedFiles];
+   unit.ufs          = new CXUnsavedFile[numUnsavedFiles];
+   unit.includeFiles = job.includeFiles;
+
+   unit.sources[0] = job.mainSource;
+
+   unit.ufs[0].Filename = strdup(job.fileName.toUtf8().constData());
+   unit.ufs[0].Contents = unit.sources[0].constData();
+   unit.ufs[0].Length   = unit.sources[0].length();
+
+   //
+   uint i = 1;
+   for (const auto &item : mappedFiles) {
+      unit.fileMapping.insert(item.first, i);
+
+      unit.sources[i]      = item.second;
+      unit.ufs[i].Filename = strdup(item.first.toUtf8().constData());
+      unit.ufs[i].Contents = unit.sources[i].constData();
+      unit.ufs[i].Length   = unit.sources[i].length();
+
+      i++;
+   }
+
+   // copy data to a usable vector for clang
+   std::vector<const char *> argv;
+   for (auto &item : job.argList) {
+      argv.push_back(item.constData());
+   }
+
+   int argc = job.argList.size();
+
+   // passed data - index, 0, command line args, number of args, included files
+   // num of unsaved files, clang flag indicating full preprocessing, translation unit structure
+
+   // libClang - used to set up the tokens for comments
+   job.errorCode = clang_parseTranslationUnit2(unit.index, 0, &argv[0], argc, unit.ufs, numUnsavedFiles,
+                  CXTranslationUnit_DetailedPreprocessingRecord, &(unit.tu) );
+
+   if (job.errorCode != CXError_Success) {
+      return;
+   }
+
+   if (job.buildAST) {
+      // save argList in a different vector for libTooling
+      std::vector<std::string> argTmp;
+
+      for (auto &item : job.argList) {
+         argTmp.push_back(item.constData());
+      }
+
+      // file name needed for libClang, but removed for libTooling
+      argTmp.erase(argTmp.end() - 1);
+
+      // libTooling - used to parse the source, the file in memory is used
+      job.ast = clang::tooling::buildASTFromCodeWithArgs(
+                  llvm::StringRef(unit.sources[0].constData(), unit.sources[0].length()), argTmp, job.fileName.constData());
+   }
+
+   // generate tokens and cursors for the main file
+   tokenizeFile(unit.tu, job.fileName, unit.ufs[0].Length, &job.tokens, &job.numTokens, &job.cursors);
+}
+
+// command line for parsing fileName, language detection depends on the files seen before
+std::vector<QString> ClangParser::buildArguments(const QString &fileName)
 {
    static QStringList const includePath          = Config::getList("include-path");
    static QStringList const preDefinedMacros     = Config::getList("predefined-macros");
@@ -703,64 +1286,99 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
          break;
    }
 
+   // headers common to all translation units are loaded from a precompiled header
+   QString pchFile = precompiledHeader(argList);
+
+   if (! pchFile.isEmpty()) {
+      // keep "-x" and the language id last
+      argList.insert(argList.end() - 2, { QString("-include-pch"), pchFile });
+   }
+
    // file name added
    argList.push_back(fileName);
 
-   // exclude PCH files, disable diagnostics
-   p->index    = clang_createIndex(false, false);
-
-   p->fileName = fileName;
-   p->curLine  = 1;
-   p->curToken = 0;
+   return argList;
+}
 
-   // provide the input and their dependencies as files in memory
+// ** entry point
+void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStringList &includeFiles, QSharedPointer<Entry> root)
+{
    static bool filterSourceFiles = Config::getBool("filter-source-files");
 
-   uint numUnsavedFiles = includeFiles.count() + 1;
-
-   p->numFiles = numUnsavedFiles;
-   p->sources  = new QByteArray[numUnsavedFiles];
-   p->ufs      = new CXUnsavedFile[numUnsavedFiles];
-
    // load main file
+   QByteArray mainSource;
+
    if (fileBuffer.isEmpty()) {
-      p->sources[0]   = detab(fileToString(fileName, filterSourceFiles, true)).toUtf8();
+      mainSource = detab(fileToString(fileName, filterSourceFiles, true)).toUtf8();
+
+   } else if (root == nullptr) {
+      // source code which was read in advance by the caller
+      mainSource = detab(fileBuffer).toUtf8();
+
    } else  {
-      p->sources[0]   = fileBuffer.toUtf8();
+      mainSource = fileBuffer.toUtf8();
    }
 
-   p->ufs[0].Filename = strdup(fileName.toUtf8().constData());
-   p->ufs[0].Contents = p->sources[0].constData();
-   p->ufs[0].Length   = p->sources[0].length();
+   bool unconverted = p->unconverted;
 
-   //
-   uint i = 1;
-   for (const auto &item : includeFiles) {
-      p->fileMapping.insert(item, i);
+   p->keepUnit    = false;
+   p->unconverted = false;
 
-      // load include files
-      p->sources[i]      = detab(fileToString(item, filterSourceFiles, true)).toUtf8();
-      p->ufs[i].Filename = strdup(item.toUtf8().constData());
-      p->ufs[i].Contents = p->sources[i].constData();
-      p->ufs[i].Length   = p->sources[i].length();
+   if (root == nullptr && p->restoreUnit(fileName, mainSource, includeFiles)) {
+      // called from writeSource() in fileDef, the translation unit from parsing this file is reused
+      determineInputFiles(includeFiles);
+      p->tokenizeFile(fileName, p->ufs[0].Length);
 
-      i++;
+      return;
    }
 
-   // copy data to a usable vector for clang
-   std::vector<const char *> argv;
-   for (auto &item : argList) {
-      argv.push_back(item.constData());
+   ClangUnitJob *job = nullptr;
+
+   if (p->pool != nullptr && root != nullptr) {
+      // translation unit may have been parsed by a worker thread
+      job = p->pool->take(fileName);
+
+      if (job != nullptr && (job->mainSource != mainSource || job->includeFiles != includeFiles)) {
+         disposeJob(*job);
+         delete job;
+
+         job = nullptr;
+      }
    }
 
-   int argc = argList.size();
+   if (job == nullptr) {
+      job = new ClangUnitJob;
 
-   // passed data - index, 0, command line args, number of args, included files
-   // num of unsaved files, clang flag indicating full preprocessing, translation unit structure
+      job->fileName     = fileName;
+      job->mainSource   = mainSource;
+      job->includeFiles = includeFiles;
+      job->argList      = buildArguments(fileName);
+      job->buildAST     = (root != nullptr);
 
-   // libClang - used to set up the tokens for comments
-   CXErrorCode errorCode = clang_parseTranslationUnit2(p->index, 0, &argv[0], argc, p->ufs, numUnsavedFiles,
-                  CXTranslationUnit_DetailedPreprocessingRecord, &(p->tu) );
+      parseUnit(*job);
+   }
+
+   p->index       = job->unit.index;
+   p->tu          = job->unit.tu;
+   p->sources     = job->unit.sources;
+   p->ufs         = job->unit.ufs;
+   p->numFiles    = job->unit.numFiles;
+   p->fileMapping  = job->unit.fileMapping;
+   p->includeFiles = job->unit.includeFiles;
+   p->tokens      = job->tokens;
+   p->numTokens   = job->numTokens;
+   p->cursors     = job->cursors;
+
+   p->clearTokenIndex();
+
+   p->fileName = fileName;
+   p->curLine  = 1;
+   p->curToken = 0;
+
+   CXErrorCode errorCode = job->errorCode;
+   std::unique_ptr<clang::ASTUnit> ast = std::move(job->ast);
+
+   delete job;
 
    if (p->tu) {
       // filter out any includes not found by the clang parser
@@ -788,89 +1406,27 @@ void ClangParser::start(const QString &fileName, const QString &fileBuffer, QStr
 
       if (root == nullptr)  {
          // called from writeSouce() in fileDef
-
-      } else {
-         // libTooling - used to parse the source
-         const std::string stdFName = fileName.constData();
-
-         // start adding to our entry container
-         s_current_root = root;
-         s_entryMap.insert("TranslationUnit", root);
-
-         if (false) {
-/*
-         if (! useFallBack)  {
-            // hold for now
-
-            QString tmp;
-            for (auto item : argList) {
-               tmp += item + "  ";
-            }
-            printf("\n Args: %s\n", csPrintable(tmp) );
-
-            llvm::cl::OptionCategory category("doxypress");
-            clang::tooling::CommonOptionsParser options(argc, &argv[0], category);
-
-            // pass the main file name seperately
-            std::vector<std::string> sourceList;
-            sourceList.push_back(stdFName);
-
-            // create a new clang tooling instance
-            clang::tooling::ClangTool tool(options.getCompilations(), sourceList);
-
-            // use the file in memory
-            tool.mapVirtualFile(stdFName, p->sources[0].constData());
-
-            // run the clang tooling to create a new FrontendAction
-            int result = tool.run(clang::tooling::newFrontendActionFactory<DoxyFrontEnd>().get());
-*/
-
-         } else {
-            // save argList in a different vector for libTooling
-            std::vector<std::string> argTmp;
-
-            for (auto &item : argList) {
-               argTmp.push_back(item.constData());
-            }
-
-            // file name needed for libClang, but removed for libTooling
-            argTmp.erase(argTmp.end() - 1);
-
-            clang::tooling::FixedCompilationDatabase options(".", argTmp);
-
-            // pass the main file name seperately
-            std::vector<std::string> sourceList;
-            sourceList.push_back(stdFName);
-
-            // create a new clang tooling instance
-            clang::tooling::ClangTool tool(options, sourceList);
-
-            // use the file in memory
-            tool.mapVirtualFile(stdFName, p->sources[0].constData());
-
-            // run the clang tooling to create a new FrontendAction
-            int result = tool.run(clang::tooling::newFrontendActionFactory<DoxyFrontEnd>().get());
-         }
+         return;
       }
 
-      // create a source range for the file
-      QFileInfo fi(fileName);
-      CXFile f = clang_getFile(p->tu, fileName.toUtf8().constData());
-
-      CXSourceLocation fileBegin = clang_getLocationForOffset(p->tu, f, 0);
-      CXSourceLocation fileEnd   = clang_getLocationForOffset(p->tu, f, p->ufs[0].Length);
-      CXSourceRange    fileRange = clang_getRange(fileBegin, fileEnd);
+      // start adding to our entry container
+      s_current_root = root;
+      s_entryMap.insert("TranslationUnit", root);
 
-      // generate tokens for the tu
-      clang_tokenize(p->tu, fileRange, &p->tokens, &p->numTokens);
+      // libTooling - used to parse the source
+      if (ast != nullptr) {
+         visitTranslationUnit(*ast);
+         ast.reset();
+      }
 
-      // generate cursors for each token
-      p->cursors = new CXCursor[p->numTokens];
-      clang_annotateTokens(p->tu, p->tokens, p->numTokens, p->cursors);
+      // save the translation unit when the source code will be written or parsed for references,
+      // only useful if the parsed text is the text writeSource() passes, which is filtered as source
+      // code and has its tabs expanded, restoreUnit() compares the text
+      static const bool sourceCode = Config::getBool("source-code");
 
-      if (root == nullptr)  {
-         // called from writeSouce() in fileDef
-         return;
+      if (sourceCode || Doxy_Globals::parseSourcesNeeded) {
+         bool sameFilter = getFileFilter(fileName, false) == (filterSourceFiles ? getFileFilter(fileName, true) : QString());
+         p->keepUnit = fileBuffer.isEmpty() || (unconverted && sameFilter && ! mainSource.contains('\t'));
       }
 
       static const bool javadoc_auto_brief = Config::getBool("javadoc-auto-brief");
@@ -1119,26 +1675,95 @@ void ClangParser::finish()
       delete[] p->cursors;
 
       clang_disposeTokens(p->tu, p->tokens, p->numTokens);
-      clang_disposeTranslationUnit(p->tu);
-      clang_disposeIndex(p->index);
 
-      p->fileMapping.clear();
       p->tokens    = 0;
       p->numTokens = 0;
       p->cursors   = 0;
+
+      p->clearTokenIndex();
+   }
+
+   if (p->keepUnit && p->tu && s_unitDir == nullptr) {
+      s_unitDir = new QTemporaryDir(QDir::tempPath() + "/doxypress_units_XXXXXX");
+
+      if (! s_unitDir->isValid()) {
+         err("Unable to create a temporary directory for clang translation units\n");
+      }
+   }
+
+   if (p->keepUnit && p->tu && s_unitDir->isValid()) {
+      // loaded again when the source code for this file is written
+      QString name = QString::fromLatin1(QCryptographicHash::hash(p->fileName.toUtf8(), QCryptographicHash::Sha1).toHex());
+
+      ClangUnitFile unitFile;
+      unitFile.fileName = s_unitDir->path() + "/doxy_unit_" + name + ".ast";
+      unitFile.key      = unitKey(p->sources[0], p->includeFiles);
+
+      if (clang_saveTranslationUnit(p->tu, unitFile.fileName.toUtf8().constData(),
+                  clang_defaultSaveOptions(p->tu)) == CXSaveError_None) {
+
+         s_savedUnits.insert(p->fileName, unitFile);
+      }
    }
 
-   for (uint i = 0; i < p->numFiles; i++) {
-      free((void *)p->ufs[i].Filename);
+   ClangSavedUnit unit = { p->index, p->tu, p->sources, p->ufs, p->numFiles, p->fileMapping, p->includeFiles };
+   disposeUnit(unit);
+
+   if (! p->unitFileName.isEmpty()) {
+      QFile::remove(p->unitFileName);
+      p->unitFileName = QString();
    }
 
-   delete[] p->ufs;
-   delete[] p->sources;
+   p->fileMapping.clear();
+   p->includeFiles.clear();
 
+   p->index     = 0;
    p->ufs       = 0;
    p->sources   = 0;
    p->numFiles  = 0;
    p->tu        = 0;
+   p->keepUnit  = false;
+}
+
+void ClangParser::setUnconverted(bool unconverted)
+{
+   p->unconverted = unconverted;
+}
+
+void ClangParser::removeSavedUnits()
+{
+   // removes the files of units which were not loaded again
+   s_savedUnits.clear();
+
+   delete s_unitDir;
+   s_unitDir = nullptr;
+}
+
+void ClangParser::prefetch(const QString &fileName, const QString &fileBuffer, const QStringList &includeFiles)
+{
+   if (p->pool == nullptr || fileBuffer.isEmpty()) {
+      return;
+   }
+
+   ClangUnitJob *job = new ClangUnitJob;
+
+   job->fileName     = fileName;
+   job->mainSource   = fileBuffer.toUtf8();
+   job->includeFiles = includeFiles;
+   job->argList      = buildArguments(fileName);
+   job->buildAST     = true;
+
+   p->pool->add(job);
+}
+
+void ClangParser::setNumThreads(int numThreads)
+{
+   delete p->pool;
+   p->pool = nullptr;
+
+   if (numThreads > 1) {
+      p->pool = new ClangUnitPool(numThreads);
+   }
 }
 
 static void handleCommentBlock(const QString &comment, bool brief, const QString &fileName, QSharedPointer<Entry> current)
@@ -1233,89 +1858,64 @@ QString ClangParser::lookup(uint line, const QString &symbol)
       return retval;
    }
 
-   int symLen     = symbol.length();
-   uint tokenLine = p->getCurrentTokenLine();
-
-   while (tokenLine >= line && p->curToken > 0) {
+   p->buildTokenIndex();
 
-      if (tokenLine == line) {
-         // already at the right line
-
-         p->curToken--;                         // linear search find the beginning of the line
-         tokenLine = p->getCurrentTokenLine();
-
-      } else {
-         p->curToken /= 2;                      // binary search backwards
-         tokenLine = p->getCurrentTokenLine();
-      }
+   if (line >= uint(p->lineFirstToken.size())) {
+      return retval;
    }
 
-   bool found = false;
-
-   while (tokenLine <= line && p->curToken < p->numTokens && ! found) {
-      CXString tokenString = clang_getTokenSpelling(p->tu, p->tokens[p->curToken]);
+   const QByteArray sym = symbol.toUtf8();
+   const int symLen     = sym.length();
 
-      const char *ts = clang_getCString(tokenString);
-      int tl         = strlen(ts);
-      int startIndex = p->curToken;
+   for (uint index = p->lineFirstToken[line]; index < p->numTokens && p->tokenLines[index] == line; ++index) {
+      const QByteArray &ts = p->tokenSpellings[index];
 
-      if (tokenLine == line && strncmp(ts, symbol.toUtf8().constData(), tl) == 0) {
-         // found partial match at the correct line
-         int offset = tl;
-
-         while (offset < symLen) {
-            // symbol spans multiple tokens
-
-            p->curToken++;
-
-            if (p->curToken >= p->numTokens) {
-               // end of token stream
-               break;
-            }
-
-            tokenLine = p->getCurrentTokenLine();
-            clang_disposeString(tokenString);
-
-            tokenString = clang_getTokenSpelling(p->tu, p->tokens[p->curToken]);
-            ts = clang_getCString(tokenString);
-            tl = ts ? strlen(ts) : 0;
-
-            // skip over any spaces in the symbol
-            QChar c;
+      if (ts.isEmpty() || ! sym.startsWith(ts)) {
+         continue;
+      }
 
-            while (offset < symLen && ((c = symbol[offset]) == ' ' || c == '\t' || c == '\r' || c == '\n')) {
-               offset++;
-            }
+      // found partial match at the correct line
+      int offset = ts.length();
+      uint lastToken = index;
 
-            if (strncmp(ts, symbol.mid(offset).toUtf8().constData(), tl) != 0) {
-               // next token does not match
-               break;
-            }
+      while (offset < symLen) {
+         // skip over any spaces in the symbol
+         char c;
 
-            offset += tl;
+         while (offset < symLen && ((c = sym[offset]) == ' ' || c == '\t' || c == '\r' || c == '\n')) {
+            offset++;
          }
 
          if (offset == symLen) {
-            // symbol matches the token(s)
-            CXCursor c   = p->cursors[p->curToken];
-            CXString usr = clang_getCursorUSR(c);
+            break;
+         }
+
+         // symbol spans multiple tokens
+         ++lastToken;
 
-            retval = QString::fromLatin1(clang_getCString(usr));
+         if (lastToken >= p->numTokens) {
+            // end of token stream
+            break;
+         }
 
-            clang_disposeString(usr);
-            found = true;
+         const QByteArray &next = p->tokenSpellings[lastToken];
 
-         } else {
-            // reset token cursor to start of the search
-            p->curToken = startIndex;
+         if (next.isEmpty() || sym.mid(offset, next.length()) != next) {
+            // next token does not match
+            break;
          }
+
+         offset += next.length();
       }
 
-      clang_disposeString(tokenString);
-      p->curToken++;
+      if (offset == symLen) {
+         // symbol matches the token(s)
+         CXString usr = clang_getCursorUSR(p->cursors[lastToken]);
+         retval = QString::fromLatin1(clang_getCString(usr));
+         clang_disposeString(usr);
 
-      if (p->curToken < p->numTokens) {
-         tokenLine = p->getCurrentTokenLine();
+         p->curToken = lastToken + 1;
+         break;
       }
    }
 
@@ -1432,22 +2032,29 @@ void ClangParser::switchToFile(const QString &fileName)
       p->numTokens = 0;
       p->cursors   = 0;
 
-      QFileInfo fi(fileName);
-      CXFile f = clang_getFile(p->tu, fileName.toUtf8().constData());
+      p->clearTokenIndex();
 
-      uint pIndex = p->fileMapping.value(fileName);
+      auto iter  = p->fileMapping.find(fileName);
+      bool found = false;
+      uint length = 0;
 
-      if (pIndex < p->numFiles) {
-         uint i = pIndex;
+      if (iter != p->fileMapping.end()) {
+         found  = true;
+         length = p->ufs[iter.value()].Length;
 
-         CXSourceLocation fileBegin = clang_getLocationForOffset(p->tu, f, 0);
-         CXSourceLocation fileEnd   = clang_getLocationForOffset(p->tu, f, p->ufs[i].Length);
-         CXSourceRange    fileRange = clang_getRange(fileBegin, fileEnd);
+      } else if (p->includeFiles.contains(fileName)) {
+         // include file was read from disk by clang
+         CXFile file = clang_getFile(p->tu, fileName.toUtf8().constData());
+         size_t size = 0;
 
-         clang_tokenize(p->tu, fileRange, &p->tokens, &p->numTokens);
+         if (file != nullptr && clang_getFileContents(p->tu, file, &size) != nullptr) {
+            found  = true;
+            length = size;
+         }
+      }
 
-         p->cursors = new CXCursor[p->numTokens];
-         clang_annotateTokens(p->tu, p->tokens, p->numTokens, p->cursors);
+      if (found) {
+         p->tokenizeFile(fileName, length);
 
          p->curLine  = 1;
          p->curToken = 0;
@@ -21,6 +21,8 @@
 
 #include <QStringList>
 
+#include <vector>
+
 #include <clang-c/Index.h>
 #include <clang-c/Documentation.h>
 
@@ -34,6 +36,7 @@ class ClangParser
    static ClangParser *instance();
 
    // fileName  name of the file to parse
+   // fileBuffer- text to parse or empty to read fileName, when root is null this is the file as read from disk
    // includeFiles- other files which are included by this file
    void start(const QString &fileName, const QString &fileBuffer, QStringList &includeFiles, QSharedPointer<Entry> root);
 
@@ -44,6 +47,18 @@ class ClangParser
    // clean up, free resources used in parsing
    void finish();
 
+   // called before start() when fileBuffer is the input file as read, without any converted comments
+   void setUnconverted(bool unconverted);
+
+   // deletes the translation units saved by finish() which were not reused
+   void removeSavedUnits();
+
+   // parses fileName on a worker thread, a later call to start() for the same file uses the result
+   void prefetch(const QString &fileName, const QString &fileBuffer, const QStringList &includeFiles);
+
+   // number of worker threads used by prefetch(), a value less than two stops the workers
+   void setNumThreads(int numThreads);
+
    // looks for a symbol which should be found at line, returns a clang unique ref to the symbol
    QString lookup(uint line, const QString &symbol);
 
@@ -70,6 +85,8 @@ class ClangParser
                   uint &column, const QString &text);
 
    void determineInputFiles(QStringList &includeFiles);
+
+   std::vector<QString> buildArguments(const QString &fileName);
 };
 
 #endif
@@ -1253,3 +1253,9 @@ std::unique_ptr<clang::ASTConsumer> DoxyFrontEnd::CreateASTConsumer(clang::Compi
 
    return std::unique_ptr<clang::ASTConsumer>(new DoxyASTConsumer(&compiler.getASTContext()));
 }
+
+void visitTranslationUnit(clang::ASTUnit &unit)
+{
+   DoxyASTConsumer consumer(&unit.getASTContext());
+   consumer.HandleTranslationUnit(unit.getASTContext());
+}
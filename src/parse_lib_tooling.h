@@ -25,6 +25,7 @@
 
 #include <clang/AST/ASTConsumer.h>
 #include <clang/AST/RecursiveASTVisitor.h>
+#include <clang/Frontend/ASTUnit.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/FrontendActions.h>
 #include <clang/Index/USRGeneration.h>
@@ -41,4 +42,7 @@ class DoxyFrontEnd : public clang::ASTFrontendAction
       std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance &compiler, llvm::StringRef file) override;
 };
 
+// adds the entries for a translation unit which was already parsed, must be called in input order
+void visitTranslationUnit(clang::ASTUnit &unit);
+
 #endif
\ No newline at end of file
@@ -29,11 +29,13 @@
 #undef UNICODE
 #define _WIN32_DCOM
 #include <windows.h>
+#include <psapi.h>
 
 #else
 
 #include <unistd.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <errno.h>
@@ -396,3 +398,64 @@ void portable_sleep(int ms)
 #endif
 }
 
+// cpu time used by this process in nano seconds, user and system time
+qint64 portable_cpuTime()
+{
+#ifdef HAVE_WINDOWS_H
+   FILETIME creationTime;
+   FILETIME exitTime;
+   FILETIME kernelTime;
+   FILETIME userTime;
+
+   if (! GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+      return 0;
+   }
+
+   // FILETIME is in units of 100 nano seconds
+   qint64 kernel = (qint64(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
+   qint64 user   = (qint64(userTime.dwHighDateTime) << 32)   | userTime.dwLowDateTime;
+
+   return (kernel + user) * 100;
+
+#else
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0;
+   }
+
+   return (qint64(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000000 +
+          (qint64(usage.ru_utime.tv_usec) + usage.ru_stime.tv_usec) * 1000;
+
+#endif
+}
+
+// peak resident memory of this process in bytes
+qint64 portable_peakMemory()
+{
+#ifdef HAVE_WINDOWS_H
+   PROCESS_MEMORY_COUNTERS counters;
+
+   if (! GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+      return 0;
+   }
+
+   return counters.PeakWorkingSetSize;
+
+#else
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0;
+   }
+
+#if defined(__APPLE__)
+   // reported in bytes
+   return usage.ru_maxrss;
+#else
+   // reported in kilobytes
+   return qint64(usage.ru_maxrss) * 1024;
+#endif
+
+#endif
+}
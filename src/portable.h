@@ -52,5 +52,8 @@ void           portable_sysTimerStop();
 double         portable_getSysElapsedTime();
 void           portable_sleep(int ms);
 
+qint64         portable_cpuTime();
+qint64         portable_peakMemory();
+
 #endif
 
@@ -19,10 +19,21 @@
 #ifndef PRE_H
 #define PRE_H
 
+class ChunkedBuffer;
+
+// the preprocessor keeps its state in file scope variables and shares defines, the run wide include guard and
+// the macro database between input files, call these functions from one thread and in input order
+
 void initPreprocessor();
 void removePreProcessor();
 void addSearchDir(const QString &dir);
-QString preprocessFile(const QString &fileName, const QString &input);
+
+// when output is set the result is appended to it in chunks while scanning and an empty string is returned
+QString preprocessFile(const QString &fileName, const QString &input, ChunkedBuffer *output = nullptr);
+
+// restores the defines, macro members and include dependencies preprocessFile() added for the same input in an
+// earlier run, returns false if the file has to be preprocessed
+bool replayPreprocessFile(const QString &fileName, const QString &input);
 void preFreeScanner();
 
 #endif
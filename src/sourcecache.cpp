@@ -0,0 +1,106 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#include <QFile>
+
+#include <sourcecache.h>
+
+#include <inputfilter.h>
+#include <message.h>
+
+// upper limit for the combined size of the cached files in bytes
+static const int s_maxCacheSize = 64 * 1024 * 1024;
+
+QCache<QString, SourceCache::FileData> SourceCache::m_cache(s_maxCacheSize);
+QMutex SourceCache::m_mutex;
+
+int SourceCache::m_hits   = 0;
+int SourceCache::m_misses = 0;
+
+bool SourceCache::getFile(const QString &fileName, const QString &filter, FileData &data)
+{
+   const QString key = filter + "\n" + fileName;
+
+   {
+      QMutexLocker locker(&m_mutex);
+      FileData *item = m_cache.object(key);
+
+      if (item != nullptr) {
+         ++m_hits;
+
+         // implicitly shared, no data is copied
+         data = *item;
+         return true;
+      }
+
+      ++m_misses;
+   }
+
+   if (! readFile(fileName, filter, data)) {
+      return false;
+   }
+
+   int cost = data.contents.size() + data.lineOffsets.size() * sizeof(int);
+
+   QMutexLocker locker(&m_mutex);
+   m_cache.insert(key, new FileData(data), cost);
+
+   return true;
+}
+
+bool SourceCache::readFile(const QString &fileName, const QString &filter, FileData &data)
+{
+   if (filter.isEmpty()) {
+      QFile f(fileName);
+
+      if (! f.open(QIODevice::ReadOnly)) {
+         return false;
+      }
+
+      data.contents = f.readAll();
+
+   } else {
+      if (! InputFilter::filterFile(filter, fileName, data.contents)) {
+         return false;
+      }
+   }
+
+   // \r\n is reduced to \n on every platform, so fragments and line offsets never contain a carriage return
+   data.contents.replace("\r\n", "\n");
+
+   data.lineOffsets.clear();
+   data.lineOffsets.append(0);
+
+   const char *p = data.contents.constData();
+   const int size = data.contents.size();
+
+   for (int i = 0; i < size; ++i) {
+      if (p[i] == '\n') {
+         data.lineOffsets.append(i + 1);
+      }
+   }
+
+   return true;
+}
+
+void SourceCache::printStatistics()
+{
+   if (m_hits + m_misses > 0) {
+      msg("Source cache used %d/%d \n", m_hits, m_hits + m_misses);
+   }
+}
@@ -0,0 +1,57 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#ifndef SOURCECACHE_H
+#define SOURCECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/** Holds the contents of source files used for inline code fragments
+ *
+ *  Each file is read (or filtered) once and a table with the offset of every line is built,
+ *  so a fragment can be located without scanning the file again. The total size of the cached
+ *  files is bounded, the least recently used files are removed first.
+ */
+class SourceCache
+{
+ public:
+   struct FileData {
+      QByteArray   contents;
+      QVector<int> lineOffsets;         // position where line n + 1 starts
+   };
+
+   // returns the contents of fileName, passed through the filter command if one is given
+   static bool getFile(const QString &fileName, const QString &filter, FileData &data);
+
+   static void printStatistics();
+
+ private:
+   static bool readFile(const QString &fileName, const QString &filter, FileData &data);
+
+   static QCache<QString, FileData> m_cache;
+   static QMutex m_mutex;
+
+   static int m_hits;
+   static int m_misses;
+};
+
+#endif
@@ -0,0 +1,167 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+
+#include <trace.h>
+
+#include <message.h>
+#include <portable.h>
+
+namespace {
+
+struct TraceEvent {
+   QString     name;
+   const char *category;
+   qint64      start;              // nano seconds
+   qint64      duration;           // nano seconds
+   int         threadId;
+};
+
+QMutex              s_traceMutex;
+QVector<TraceEvent> s_traceEvents;
+QString             s_traceFileName;
+QElapsedTimer       s_traceTimer;
+std::atomic<int>    s_nextThreadId(0);
+
+// thread ids in the trace are small numbers, in the order threads record their first event
+int traceThreadId()
+{
+   thread_local int threadId = s_nextThreadId++;
+   return threadId;
+}
+
+QString escapeJson(const QString &text)
+{
+   QString retval;
+
+   for (QChar c : text) {
+
+      if (c == '"' || c == '\\') {
+         retval += '\\';
+         retval += c;
+
+      } else if (c == '\n') {
+         retval += "\\n";
+
+      } else if (c.unicode() < 0x20) {
+         retval += QString("\\u%1").formatArg(int(c.unicode()), 4, 16, QChar('0'));
+
+      } else {
+         retval += c;
+      }
+   }
+
+   return retval;
+}
+
+}
+
+std::atomic<bool> Trace::m_enabled(false);
+
+void Trace::start(const QString &fileName)
+{
+   s_traceFileName = fileName;
+   s_traceTimer.start();
+
+   // the main thread is always track 0
+   traceThreadId();
+
+   m_enabled = true;
+}
+
+bool Trace::finish()
+{
+   if (! m_enabled) {
+      return true;
+   }
+
+   m_enabled = false;
+
+   QMutexLocker lock(&s_traceMutex);
+
+   QFile file(s_traceFileName);
+
+   if (! file.open(QIODevice::WriteOnly)) {
+      err("Unable to open file for writing the trace %s, error: %d\n", csPrintable(s_traceFileName), file.error());
+      return false;
+   }
+
+   const uint pid = portable_pid();
+
+   file.write("{\"traceEvents\":[\n");
+
+   for (int id = 0; id < s_nextThreadId; ++id) {
+      QString threadName = (id == 0) ? QString("Main") : QString("Worker %1").formatArg(id);
+
+      file.write(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%1,\"tid\":%2,\"args\":{\"name\":\"%3\"}},\n")
+            .formatArgs(pid, id, threadName).toUtf8());
+   }
+
+   bool isFirst = true;
+
+   for (const auto &event : s_traceEvents) {
+
+      if (! isFirst) {
+         file.write(",\n");
+      }
+
+      isFirst = false;
+
+      // time stamps are in micro seconds
+      file.write(QString("{\"name\":\"%1\",\"cat\":\"%2\",\"ph\":\"X\",\"ts\":%3,\"dur\":%4,\"pid\":%5,\"tid\":%6}")
+            .formatArgs(escapeJson(event.name), QString::fromLatin1(event.category), event.start / 1000,
+            event.duration / 1000, pid, event.threadId).toUtf8());
+   }
+
+   file.write("\n]}\n");
+
+   s_traceEvents.clear();
+
+   return true;
+}
+
+void Trace::addEvent(const char *category, const QString &name, qint64 start, qint64 end)
+{
+   int threadId = traceThreadId();
+
+   QMutexLocker lock(&s_traceMutex);
+   s_traceEvents.append(TraceEvent{ name, category, start, end - start, threadId });
+}
+
+Trace::Scope::Scope(const char *category, const QString &name)
+   : m_category(category), m_start(-1)
+{
+   if (Trace::isEnabled()) {
+      m_name  = name;
+      m_start = s_traceTimer.nsecsElapsed();
+   }
+}
+
+Trace::Scope::~Scope()
+{
+   if (m_start >= 0 && Trace::isEnabled()) {
+      Trace::addEvent(m_category, m_name, m_start, s_traceTimer.nsecsElapsed());
+   }
+}
@@ -0,0 +1,65 @@
+/************************************************************************
+*
+* Copyright (C) 2014-2020 Barbara Geller & Ansel Sermersheim
+* Copyright (C) 1997-2014 by Dimitri van Heesch
+*
+* DoxyPress is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License version 2
+* as published by the Free Software Foundation.
+*
+* DoxyPress is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*
+* Documents produced by DoxyPress are derivative works derived from the
+* input used in their production; they are not affected by this license.
+*
+*************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+
+#include <atomic>
+
+/** Records trace events in the Chrome trace event format
+ *
+ *  The resulting file can be loaded in chrome://tracing or the Perfetto UI. Each thread which
+ *  records an event is shown as a separate track.
+ */
+class Trace
+{
+ public:
+   // enables tracing, events are written to fileName by finish()
+   static void start(const QString &fileName);
+   static bool finish();
+
+   static bool isEnabled() {
+      return m_enabled;
+   }
+
+   /** Records a complete event from construction until destruction */
+   class Scope
+   {
+    public:
+      Scope(const char *category, const QString &name);
+      ~Scope();
+
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+
+    private:
+      const char *m_category;
+      QString m_name;
+      qint64  m_start;
+   };
+
+ private:
+   static void addEvent(const char *category, const QString &name, qint64 start, qint64 end);
+
+   // read by worker threads while the main thread calls finish()
+   static std::atomic<bool> m_enabled;
+};
+
+#endif
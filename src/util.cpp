@@ -21,13 +21,13 @@
 #include <QCryptographicHash>
 #include <QDateTime>
 #include <QHash>
-#include <QProcess>
 #include <QRegularExpression>
 #include <QTextCodec>
 
 #include <stdlib.h>
 #include <errno.h>
 #include <math.h>
+#include <string.h>
 
 #include <util.h>
 
@@ -39,6 +39,7 @@
 #include <example.h>
 #include <htmlentity.h>
 #include <image.h>
+#include <inputfilter.h>
 #include <language.h>
 #include <message.h>
 #include <portable.h>
@@ -2401,14 +2402,100 @@ QString transcodeToQString(const QByteArray &input)
 {
    static const QString inputEncoding = Config::getString("input-encoding");
 
-   QTextCodec *tmp = QTextCodec::codecForName(inputEncoding.constData());
+   // look up the codec only once
+   static QTextCodec *codec = QTextCodec::codecForName(inputEncoding.constData());
 
-   if (! tmp) {
+   if (! codec) {
       err("Unsupported character encoding: '%s'\n", csPrintable(inputEncoding));
       return input;
    }
 
-   return tmp->toUnicode(input);
+   return codec->toUnicode(input);
+}
+
+static bool inputIsUtf8()
+{
+   static const QString inputEncoding = Config::getString("input-encoding");
+   static const bool retval = inputEncoding.compare("UTF-8", Qt::CaseInsensitive) == 0 ||
+                  inputEncoding.compare("UTF8", Qt::CaseInsensitive) == 0;
+
+   return retval;
+}
+
+// true if one of the eight bytes in value is zero
+static inline bool hasZeroByte(quint64 value)
+{
+   return ((value - 0x0101010101010101ULL) & ~value & 0x8080808080808080ULL) != 0;
+}
+
+// returns the position of the first CR or NUL in data, or size if there is none
+static int findCarriageReturnOrNul(const char *data, int size)
+{
+   int pos = 0;
+
+   // test eight bytes at a time
+   while (size - pos >= 8) {
+      quint64 word;
+      memcpy(&word, data + pos, 8);
+
+      if (hasZeroByte(word) || hasZeroByte(word ^ 0x0D0D0D0D0D0D0D0DULL)) {
+         break;
+      }
+
+      pos += 8;
+   }
+
+   while (pos < size && data[pos] != '\r' && data[pos] != '\0') {
+      ++pos;
+   }
+
+   return pos;
+}
+
+/* Converts UTF-8 data to a QString and does what filterCRLF() would do in the same pass, CR LF is
+ * replaced by LF and NUL is replaced by a space. If data contains neither, no intermediate copy is made.
+ */
+static QString utf8ToFilteredString(const char *data, int size)
+{
+   int pos = findCarriageReturnOrNul(data, size);
+
+   if (pos == size) {
+      return QString::fromUtf8(data, size);
+   }
+
+   QByteArray buffer;
+   buffer.resize(size);
+
+   char *dst = buffer.data();
+
+   memcpy(dst, data, pos);
+   dst += pos;
+
+   while (pos < size) {
+      char c = data[pos];
+      ++pos;
+
+      if (c == '\r' && pos < size && data[pos] == '\n') {
+         // drop the CR of a CR LF pair
+         continue;
+
+      } else if (c == '\0') {
+         c = ' ';
+
+      }
+
+      *dst = c;
+      ++dst;
+
+      // copy the next run which needs no changes
+      int len = findCarriageReturnOrNul(data + pos, size - pos);
+
+      memcpy(dst, data + pos, len);
+      dst += len;
+      pos += len;
+   }
+
+   return QString::fromUtf8(buffer.constData(), dst - buffer.constData());
 }
 
 /*  reads a file with name and returns it as a string. If filter
@@ -7431,6 +7518,33 @@ bool readInputFile(const QString &fileName, QString &fileContents, bool filter,
       }
 
       size = fi.size();
+
+      if (size > 0 && inputIsUtf8()) {
+         // common case, decode straight from the mapped file
+         const uchar *data = f.map(0, size);
+
+         if (data != nullptr) {
+            const char *begin = reinterpret_cast<const char *>(data);
+
+            if (size >= 2 && ((data[0] == 0xFF && data[1] == 0xFE) || (data[0] == 0xFE && data[1] == 0xFF))) {
+               // UCS-2 encoded file, use the codec below
+               f.unmap(const_cast<uchar *>(data));
+
+            } else {
+               if (size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+                  // remove UTF-8 BOM
+                  begin += 3;
+                  size  -= 3;
+               }
+
+               fileContents = utf8ToFilteredString(begin, size);
+               f.unmap(const_cast<uchar *>(data));
+
+               return true;
+            }
+         }
+      }
+
       buffer.resize(size);
 
       if (f.read(buffer.data(), size) != size) {
@@ -7440,23 +7554,9 @@ bool readInputFile(const QString &fileName, QString &fileContents, bool filter,
 
    } else {
       // filter the file
-      QString cmd = filterName + " \"" + fileName + "\"";
-
-      QProcess filterProcess;
-      filterProcess.start(cmd);
-      filterProcess.waitForFinished(-1);
-
-      if (filterProcess.exitStatus() != QProcess::NormalExit) {
-         err("Unable to execute command:  %s\n", csPrintable(cmd) );
+      if (! InputFilter::filterFile(filterName, fileName, buffer)) {
          return false;
       }
-
-      buffer = filterProcess.readAllStandardOutput();
-
-      QByteArray errorMsg = filterProcess.readAllStandardError();
-       if (! errorMsg.isEmpty()) {
-         err("Possible filter problem: %s\n", errorMsg.constData());
-      }
    }
 
    uchar tmp0 = 0;
@@ -7524,53 +7624,125 @@ QString filterTitle(const QString &title)
 
 bool patternMatch(const QFileInfo &fi, const QStringList &patList)
 {
-   static Qt::CaseSensitivity ignoreCase = Config::getCase("case-sensitive-fname");
+   return PatternMatcher(patList).match(fi);
+}
+
+PatternMatcher::PatternMatcher(const QStringList &patList)
+{
+   m_caseSensitive = Config::getCase("case-sensitive-fname");
 
    // For Windows and Mac OS X always do the case insensitive match
 #if defined(_WIN32) || defined(__MACOSX__)
-   ignoreCase = Qt::CaseInsensitive;
+   m_caseSensitive = Qt::CaseInsensitive;
 #endif
 
-   bool found = false;
+   static const QRegularExpression wildcards("[*?\\[\\]\\\\]");
 
-   QString fn  = fi.fileName();
-   QString fp  = fi.filePath();
-   QString afp = fi.absoluteFilePath();
+   for (auto pattern : patList) {
 
-   QRegularExpression regExp;
+      if (pattern.isEmpty()) {
+         continue;
+      }
 
-   for (auto pattern : patList) {
+      int i = pattern.indexOf('=');
 
-      if (! pattern.isEmpty()) {
-         int i = pattern.indexOf('=');
+      if (i != -1) {
+         pattern = pattern.left(i);   // strip off the extension
+      }
 
-         if (i != -1) {
-            pattern = pattern.left(i);   // strip off the extension
-         }
+      Pattern item;
+
+      QString inner = pattern;
+      bool leadingStar  = false;
+      bool trailingStar = false;
+
+      if (inner.startsWith('*')) {
+         inner = inner.mid(1);
+         leadingStar = true;
+      }
 
-         if (ignoreCase == Qt::CaseInsensitive) {
-            regExp = QRegularExpression(pattern, QPatternOption::CaseInsensitiveOption | QPatternOption::WildcardOption |
+      if (inner.endsWith('*')) {
+         inner.chop(1);
+         trailingStar = true;
+      }
+
+      if (inner.isEmpty() || inner.contains(wildcards)) {
+         // complex pattern, use a regular expression
+         item.kind = PatternKind::RegExp;
+
+         if (m_caseSensitive == Qt::CaseInsensitive) {
+            item.regExp = QRegularExpression(pattern, QPatternOption::CaseInsensitiveOption | QPatternOption::WildcardOption |
                   QPatternOption::ExactMatchOption);
 
          } else  {
-            regExp = QRegularExpression(pattern, QPatternOption::WildcardOption | QPatternOption::ExactMatchOption);
+            item.regExp = QRegularExpression(pattern, QPatternOption::WildcardOption | QPatternOption::ExactMatchOption);
 
          }
 
-         // input-patterns
-         // possilbe issue if the pattern has something other than a wildcard for the name
-         // found = re.indexIn(fn) != -1 || re.indexIn(fp) != -1 || re.indexIn(afp) != -1;
+      } else {
+         item.text = inner;
 
-         found = fn.contains(regExp) || fp.contains(regExp) || afp.contains(regExp);
+         if (leadingStar && trailingStar) {
+            item.kind = PatternKind::Contains;
+
+         } else if (leadingStar) {
+            item.kind = PatternKind::Suffix;
+
+         } else if (trailingStar) {
+            item.kind = PatternKind::Prefix;
+
+         } else {
+            item.kind = PatternKind::Exact;
 
-         if (found) {
-            break;
          }
       }
 
+      m_patterns.append(item);
+   }
+}
+
+bool PatternMatcher::matchName(const Pattern &pattern, const QString &name) const
+{
+   switch (pattern.kind) {
+      case PatternKind::Exact:
+         return name.compare(pattern.text, m_caseSensitive) == 0;
+
+      case PatternKind::Prefix:
+         return name.startsWith(pattern.text, m_caseSensitive);
+
+      case PatternKind::Suffix:
+         return name.endsWith(pattern.text, m_caseSensitive);
+
+      case PatternKind::Contains:
+         return name.contains(pattern.text, m_caseSensitive);
+
+      case PatternKind::RegExp:
+         return name.contains(pattern.regExp);
+   }
+
+   return false;
+}
+
+bool PatternMatcher::match(const QFileInfo &fi) const
+{
+   if (m_patterns.isEmpty()) {
+      return false;
+   }
+
+   QString fn  = fi.fileName();
+   QString fp  = fi.filePath();
+   QString afp = fi.absoluteFilePath();
+
+   for (auto &pattern : m_patterns) {
+      // input-patterns
+      // possilbe issue if the pattern has something other than a wildcard for the name
+
+      if (matchName(pattern, fn) || matchName(pattern, fp) || matchName(pattern, afp)) {
+         return true;
+      }
    }
 
-   return found;
+   return false;
 }
 
 QString externalLinkTarget()
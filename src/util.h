@@ -22,8 +22,10 @@
 #include <QList>
 #include <QDir>
 #include <QFileInfo>
+#include <QRegularExpression>
 #include <QStringList>
 #include <QTextStream>
+#include <QVector>
 
 #include <ctype.h>
 #include <types.h>
@@ -117,6 +119,45 @@ inline bool isId(QChar c)
    return false;
 }
 
+/** List of wildcard file patterns compiled once and matched against many files
+ *
+ *  Patterns of the form *.ext, *text*, text* and plain names are compared directly, any
+ *  other pattern is converted to a regular expression.
+ */
+class PatternMatcher
+{
+ public:
+   PatternMatcher() = default;
+   PatternMatcher(const QStringList &patList);
+
+   bool isEmpty() const {
+      return m_patterns.isEmpty();
+   }
+
+   // true if the name, path or absolute path of fi matches one of the patterns
+   bool match(const QFileInfo &fi) const;
+
+ private:
+   enum class PatternKind {
+      Exact,
+      Prefix,
+      Suffix,
+      Contains,
+      RegExp
+   };
+
+   struct Pattern {
+      PatternKind kind;
+      QString text;
+      QRegularExpression regExp;
+   };
+
+   bool matchName(const Pattern &pattern, const QString &name) const;
+
+   QVector<Pattern> m_patterns;
+   Qt::CaseSensitivity m_caseSensitive = Qt::CaseSensitive;
+};
+
 // Data associated with a HSV colored image.
 struct ColoredImgDataItem {
    QString  path;